@@ -4,11 +4,15 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
+#include <string.h>
 #include <math.h>
 #include "Antena.h"
 #include "Grafo.h"
 #include "Nefasto.h"
 #include "Ficheiros.h"
+#include "Indice.h"
+#include "Metricas.h"
 #pragma region Antenas
 /** 
  * @file Antena.c
@@ -34,11 +38,38 @@ VAntena* criarAntena(char freq, int linha, int coluna) {
     atual->frequencia = freq;
     atual->linha = linha;
     atual->coluna = coluna;
+    atual->visitado = false;
     atual->listaAdj = NULL;
     atual->proximo = NULL;
+    atual->anterior = NULL;
+    atual->posicaoBalde = -1;
+    atual->id = -1;
+    atual->componente = -1;
+    atual->ligadaFrequencia = false;
+    atual->grafo = NULL;
     return atual;
 }
 
+/**
+ * @brief Corpo de inserirAntena, sem a medição de tempo (ver inserirAntena).
+ */
+static bool inserirAntenaInterno(Grafo* g, char freq, int linha, int coluna) {
+    if (!g) return false;
+
+    if (posicaoOcupada(g, linha, coluna)) {
+        return false;
+    }
+
+    VAntena* novaAntena = novoVertice(g, freq, linha, coluna);
+    if (!novaAntena) return false;
+
+    if (!registarVertice(g, novaAntena)) {
+        libertarVertice(novaAntena);
+        return false;
+    }
+    return true;
+}
+
 /**
  * @brief Insere uma antena no grafo, se a posição estiver livre.
  * @param g Ponteiro para o grafo.
@@ -50,23 +81,22 @@ VAntena* criarAntena(char freq, int linha, int coluna) {
 
 // Inserir antena na lista ligada
 bool inserirAntena(Grafo* g, char freq, int linha, int coluna) {
-    if (!g) return false;
-
-    if (posicaoOcupada(g, linha, coluna)) {
-        return false;
-    }
-
-    VAntena* novaAntena = criarAntena(freq, linha, coluna);
-    if (!novaAntena) return false;
+    METRICA_INICIO(inicio);
+    bool r = inserirAntenaInterno(g, freq, linha, coluna);
+    METRICA_FIM(g, METRICA_INSERIR_ANTENA, inicio);
+    return r;
+}
 
-    novaAntena->proximo = g->listaAntenas;
-    g->listaAntenas = novaAntena;
-    g->numAntenas++;
-    return true;
+/**
+ * @brief Corpo de RemoverAntena, sem a medição de tempo (ver RemoverAntena).
+ */
+static bool RemoverAntenaInterno(Grafo* g, char freq, int linha, int coluna) {
+    // As adjacências de e para a antena têm de sair antes de o nó voltar à arena
+    return removerVertice(g, freq, linha, coluna);
 }
 
 /**
- * @brief Remove uma antena da lista ligada do grafo (não remove adjacências).
+ * @brief Remove uma antena do grafo, com as adjacências de e para ela (ver removerVertice).
  * @param g Ponteiro para o grafo.
  * @param freq Frequência da antena.
  * @param linha Linha da antena.
@@ -75,24 +105,112 @@ bool inserirAntena(Grafo* g, char freq, int linha, int coluna) {
  */
 // Remover antena da lista ligada
 bool RemoverAntena(Grafo* g, char freq, int linha, int coluna) {
-    VAntena* atual = g->listaAntenas;
-    VAntena* Anterior = NULL;
-
-    while (atual != NULL) {
-        if (atual->frequencia == freq && atual->linha == linha && atual->coluna == coluna) {
-            if (Anterior == NULL) {
-                g->listaAntenas = atual->proximo;
-            } else {
-                Anterior->proximo = atual->proximo;
-            }
-            free(atual);
-            g->numAntenas--;
-            return true; // Removido com sucesso
-        }
-        Anterior = atual;
-        atual = atual->proximo;
+    METRICA_INICIO(inicio);
+    bool r = RemoverAntenaInterno(g, freq, linha, coluna);
+    METRICA_FIM(g, METRICA_REMOVER_ANTENA, inicio);
+    return r;
+}
+
+/**
+ * @brief Chave de ordenação de uma posição: linha e coluna como inteiros sem sinal (bit de sinal trocado),
+ *        para a ordem das chaves ser a ordem (linha, coluna).
+ * @param linha Linha.
+ * @param coluna Coluna.
+ * @return Chave de 64 bits.
+ */
+static uint64_t chavePosicao(int linha, int coluna) {
+    return ((uint64_t)((uint32_t)linha ^ 0x80000000u) << 32) | ((uint32_t)coluna ^ 0x80000000u);
+}
+
+/**
+ * @brief Ordena índices pelas chaves (radix sort LSD, um byte por passagem, estável).
+ * @details Passagens em que todas as chaves têm o mesmo byte são saltadas (p.ex. os bytes altos das linhas).
+ * @param chaves Chave de cada índice.
+ * @param ordem Índices a ordenar (0..num-1).
+ * @param auxiliar Vetor auxiliar com num posições.
+ * @param num Número de índices.
+ */
+static void ordenarPorChave(const uint64_t* chaves, int* ordem, int* auxiliar, int num) {
+    for (int byte = 0; byte < 8; byte++) {
+        int shift = byte * 8;
+        int contagem[257] = { 0 };
+        for (int i = 0; i < num; i++) contagem[((chaves[ordem[i]] >> shift) & 0xFF) + 1]++;
+        if (contagem[((chaves[ordem[0]] >> shift) & 0xFF) + 1] == num) continue;
+        for (int d = 0; d < 256; d++) contagem[d + 1] += contagem[d];
+        for (int i = 0; i < num; i++) auxiliar[contagem[(chaves[ordem[i]] >> shift) & 0xFF]++] = ordem[i];
+        memcpy(ordem, auxiliar, (size_t)num * sizeof(int));
+    }
+}
+
+/**
+ * @brief Corpo de inserirAntenasLote, sem a medição de tempo (ver inserirAntenasLote).
+ */
+static int inserirAntenasLoteInterno(Grafo* g, const RegistoAntena* registos, int num) {
+    if (!g || (!registos && num > 0) || num < 0) return -1;
+    if (num == 0) return 0;
+
+    uint64_t* chaves = malloc((size_t)num * sizeof(uint64_t));
+    int* ordem = malloc((size_t)num * sizeof(int));
+    int* auxiliar = malloc((size_t)num * sizeof(int));
+    bool* aceite = calloc((size_t)num, sizeof(bool));
+    VAntena** novas = malloc((size_t)num * sizeof(VAntena*));
+    if (!chaves || !ordem || !auxiliar || !aceite || !novas) {
+        free(chaves);
+        free(ordem);
+        free(auxiliar);
+        free(aceite);
+        free(novas);
+        return -1;
+    }
+    for (int i = 0; i < num; i++) {
+        chaves[i] = chavePosicao(registos[i].linha, registos[i].coluna);
+        ordem[i] = i;
+    }
+    ordenarPorChave(chaves, ordem, auxiliar, num);
+
+    // Em cada sequência de posições iguais a primeira é a mais antiga do lote (ordenação estável)
+    for (int k = 0; k < num; k++) {
+        int i = ordem[k];
+        if (k > 0 && chaves[ordem[k - 1]] == chaves[i]) continue;
+        if (consultarIndice(&g->indice, registos[i].linha, registos[i].coluna)) continue;
+        aceite[i] = true;
     }
-    return false; // Não existe antena nessa posição
+    free(chaves);
+    free(ordem);
+    free(auxiliar);
+
+    int numNovas = 0;
+    bool ok = true;
+    for (int i = 0; i < num && ok; i++) {
+        if (!aceite[i]) continue;
+        VAntena* nova = novoVertice(g, registos[i].frequencia, registos[i].linha, registos[i].coluna);
+        if (nova) novas[numNovas++] = nova;
+        else ok = false;
+    }
+    free(aceite);
+
+    int ligadas = ok ? registarVerticesLote(g, novas, numNovas) : -1;
+    for (int i = ligadas < 0 ? 0 : ligadas; i < numNovas; i++) libertarVertice(novas[i]);
+    free(novas);
+    return ligadas;
+}
+
+/**
+ * @brief Insere de uma vez um lote de antenas no grafo.
+ * @details Os registos são ordenados por posição (radix sort estável); numa só passagem pelas posições
+ *          ordenadas fica apenas a primeira ocorrência de cada posição do lote, e só se estiver livre no grafo
+ *          (consulta O(1) ao índice de posições). As antenas aceites são ligadas de uma vez, pela ordem do lote,
+ *          com registarVerticesLote. O resultado é o mesmo que chamar inserirAntena para cada registo.
+ * @param g Ponteiro para o grafo.
+ * @param registos Antenas a inserir.
+ * @param num Número de registos.
+ * @return Número de antenas inseridas, ou -1 em caso de erro.
+ */
+int inserirAntenasLote(Grafo* g, const RegistoAntena* registos, int num) {
+    METRICA_INICIO(inicio);
+    int r = inserirAntenasLoteInterno(g, registos, num);
+    METRICA_FIM(g, METRICA_INSERIR_LOTE, inicio);
+    return r;
 }
 
 /**
@@ -107,13 +225,7 @@ bool RemoverAntena(Grafo* g, char freq, int linha, int coluna) {
 bool posicaoOcupada(Grafo* g, int linha, int coluna) {
     if (!g || !g->listaAntenas) return false;
 
-        VAntena* atual = g->listaAntenas;
-    for (atual = g->listaAntenas; atual != NULL; atual = atual->proximo) {
-        if (atual->linha == linha && atual->coluna == coluna) {
-            return true;
-        }
-    }
-    return false;
+    return consultarIndice(&g->indice, linha, coluna) != NULL;
 }
 
 #pragma endregion
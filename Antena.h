@@ -32,7 +32,7 @@ VAntena* criarAntena(char freq, int linha, int coluna);
 bool inserirAntena(Grafo* g, char freq, int linha, int coluna);
 
 /**
- * @brief Remove uma antena da lista ligada do grafo.
+ * @brief Remove uma antena do grafo, com as adjacências de e para ela.
  * @param g Ponteiro para o grafo.
  * @param freq Frequência.
  * @param linha Linha.
@@ -41,6 +41,17 @@ bool inserirAntena(Grafo* g, char freq, int linha, int coluna);
  */
 bool RemoverAntena(Grafo* g, char freq, int linha, int coluna);
 
+/**
+ * @brief Insere de uma vez um lote de antenas no grafo (ordenação por posição, sem repetidos).
+ * @details Fica a primeira ocorrência de cada posição do lote, se estiver livre no grafo; o resultado é o
+ *          mesmo que chamar inserirAntena para cada registo, pela ordem do lote.
+ * @param g Ponteiro para o grafo.
+ * @param registos Antenas a inserir.
+ * @param num Número de registos.
+ * @return Número de antenas inseridas, ou -1 em caso de erro.
+ */
+int inserirAntenasLote(Grafo* g, const RegistoAntena* registos, int num);
+
 /**
  * @brief Verifica se uma posição está ocupada por uma antena.
  * @param g Ponteiro para o grafo.
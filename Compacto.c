@@ -0,0 +1,397 @@
+#ifndef COMPACTO_C
+#define COMPACTO_C
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <limits.h>
+#include "Grafo.h"
+#include "Nefasto.h"
+#include "Indice.h"
+#include "Memoria.h"
+#include "Compacto.h"
+#include "Metricas.h"
+/**
+ * @file Compacto.c
+ * @brief Implementação do grafo compacto (CSR): construção, travessia e efeitos nefastos.
+ * @author João Novais
+ * @date 2025-05-18
+ *
+ */
+
+#pragma region Compacto
+
+/**
+ * @brief Compara duas antenas por (linha, coluna), para qsort.
+ * @param a Ponteiro para VAntena*.
+ * @param b Ponteiro para VAntena*.
+ * @return Negativo, zero ou positivo.
+ */
+static int compararPosicaoAntenas(const void* a, const void* b) {
+    const VAntena* x = *(VAntena* const*)a;
+    const VAntena* y = *(VAntena* const*)b;
+    if (x->linha != y->linha) return x->linha < y->linha ? -1 : 1;
+    if (x->coluna != y->coluna) return x->coluna < y->coluna ? -1 : 1;
+    return 0;
+}
+
+/**
+ * @brief Indica se uma adjacência explícita já está coberta pelas ligações implícitas da frequência.
+ * @param g Ponteiro para o grafo.
+ * @param origem Antena de origem.
+ * @param destino Antena de destino.
+ * @return true se a ligação é dada pelo grupo de frequência (e não vai para destinos), false caso contrário.
+ */
+static bool ligacaoImplicita(const Grafo* g, const VAntena* origem, const VAntena* destino) {
+    return g->frequenciasLigadas && origem->ligadaFrequencia && destino->ligadaFrequencia &&
+           origem->frequencia == destino->frequencia;
+}
+
+/**
+ * @brief Corpo de congelarGrafo, sem a medição de tempo (ver congelarGrafo).
+ */
+static GrafoCompacto* congelarGrafoInterno(Grafo* g) {
+    if (!g) return NULL;
+
+    GrafoCompacto* gc = calloc(1, sizeof(GrafoCompacto));
+    if (!gc) return NULL;
+    int n = g->numAntenas;
+    gc->numAntenas = n;
+    gc->linhas = g->linhas;
+    gc->colunas = g->colunas;
+    gc->frequenciasLigadas = g->frequenciasLigadas;
+
+    // Conta só as arestas explícitas: as ligações implícitas ficam nos grupos de frequência
+    size_t numArestas = 0;
+    for (int i = 0; i < n; i++) {
+        VAntena* origem = g->vertices[i];
+        for (Adjacente* adj = origem->listaAdj; adj != NULL; adj = adj->proximo) {
+            if (!ligacaoImplicita(g, origem, adj->destino)) numArestas++;
+        }
+    }
+    if (numArestas > INT_MAX || numArestas > SIZE_MAX / sizeof(int)) {
+        libertarGrafoCompacto(gc);
+        return NULL;
+    }
+    gc->numArestas = (int)numArestas;
+
+    VAntena** ordem = malloc((size_t)(n ? n : 1) * sizeof(VAntena*));
+    int* posicao = malloc((size_t)(n ? n : 1) * sizeof(int));
+    gc->frequencia = malloc((size_t)(n ? n : 1));
+    gc->linha = malloc((size_t)(n ? n : 1) * sizeof(int));
+    gc->coluna = malloc((size_t)(n ? n : 1) * sizeof(int));
+    gc->inicioAdj = malloc((size_t)(n + 1) * sizeof(int));
+    gc->destinos = malloc((numArestas ? numArestas : 1) * sizeof(int));
+    if (gc->frequenciasLigadas) gc->ligada = malloc((size_t)(n ? n : 1) * sizeof(bool));
+    if (!ordem || !posicao || !gc->frequencia || !gc->linha || !gc->coluna ||
+        !gc->inicioAdj || !gc->destinos || (gc->frequenciasLigadas && !gc->ligada)) {
+        free(ordem);
+        free(posicao);
+        libertarGrafoCompacto(gc);
+        return NULL;
+    }
+
+    // Agrupa por frequência (os baldes já dão os grupos) e ordena cada grupo por posição
+    int k = 0;
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+        BaldeFrequencia* b = &g->baldes[f];
+        gc->inicioFrequencia[f] = k;
+        for (int i = 0; i < b->numAntenas; i++) ordem[k + i] = b->antenas[i];
+        qsort(ordem + k, (size_t)b->numAntenas, sizeof(VAntena*), compararPosicaoAntenas);
+        k += b->numAntenas;
+    }
+    gc->inicioFrequencia[NUM_FREQUENCIAS] = k;
+
+    for (int i = 0; i < n; i++) {
+        gc->frequencia[i] = ordem[i]->frequencia;
+        gc->linha[i] = ordem[i]->linha;
+        gc->coluna[i] = ordem[i]->coluna;
+        if (gc->ligada) gc->ligada[i] = ordem[i]->ligadaFrequencia;
+        posicao[ordem[i]->id] = i;
+    }
+
+    // Adjacências explícitas que o grupo de frequência não cobre
+    int e = 0;
+    for (int i = 0; i < n; i++) {
+        gc->inicioAdj[i] = e;
+        for (Adjacente* adj = ordem[i]->listaAdj; adj != NULL; adj = adj->proximo) {
+            if (!ligacaoImplicita(g, ordem[i], adj->destino)) gc->destinos[e++] = posicao[adj->destino->id];
+        }
+    }
+    gc->inicioAdj[n] = e;
+
+    free(ordem);
+    free(posicao);
+    return gc;
+}
+
+/**
+ * @brief Compila o grafo para um GrafoCompacto (CSR) só de leitura.
+ * @details As antenas ficam agrupadas por frequência e ordenadas por (linha, coluna) dentro de cada grupo.
+ *          As ligações implícitas entre antenas da mesma frequência não são expandidas: ficam como uma marca por
+ *          antena e o grupo de frequência, pelo que memória e tempo são O(N + E explícitas).
+ *          O grafo original não é alterado e pode ser libertado depois de congelado.
+ * @param g Ponteiro para o grafo.
+ * @return Ponteiro para o grafo compacto, ou NULL em caso de erro.
+ */
+GrafoCompacto* congelarGrafo(Grafo* g) {
+    METRICA_INICIO(inicio);
+    GrafoCompacto* r = congelarGrafoInterno(g);
+    METRICA_FIM(g, METRICA_CONGELAR, inicio);
+    return r;
+}
+
+/**
+ * @brief Liberta a memória de um grafo compacto.
+ * @param gc Ponteiro para o grafo compacto.
+ * @return true após libertar.
+ */
+bool libertarGrafoCompacto(GrafoCompacto* gc) {
+    if (!gc) return false;
+    free(gc->frequencia);
+    free(gc->linha);
+    free(gc->coluna);
+    free(gc->inicioAdj);
+    free(gc->destinos);
+    free(gc->ligada);
+    free(gc);
+    return true;
+}
+
+/**
+ * @brief Procura o índice de uma antena no grafo compacto (pesquisa binária no grupo da frequência).
+ * @param gc Ponteiro para o grafo compacto.
+ * @param freq Frequência.
+ * @param linha Linha.
+ * @param coluna Coluna.
+ * @return Índice da antena, ou -1 se não existir.
+ */
+int procurarAntenaCompacto(const GrafoCompacto* gc, char freq, int linha, int coluna) {
+    if (!gc) return -1;
+    int inicio = gc->inicioFrequencia[(unsigned char)freq];
+    int fim = gc->inicioFrequencia[(unsigned char)freq + 1] - 1;
+    while (inicio <= fim) {
+        int meio = inicio + (fim - inicio) / 2;
+        if (gc->linha[meio] == linha && gc->coluna[meio] == coluna) return meio;
+        if (gc->linha[meio] < linha || (gc->linha[meio] == linha && gc->coluna[meio] < coluna))
+            inicio = meio + 1;
+        else
+            fim = meio - 1;
+    }
+    return -1;
+}
+
+/**
+ * @brief Imprime todas as antenas e as suas ligações do grafo compacto.
+ * @details As ligações implícitas da frequência são impressas a seguir às explícitas, a partir do grupo.
+ * @param gc Ponteiro para o grafo compacto.
+ * @return true se imprimiu, false se está vazio ou é inválido.
+ */
+bool imprimirGrafoCompacto(const GrafoCompacto* gc) {
+    if (!gc || gc->numAntenas == 0) return false;
+
+    for (int i = 0; i < gc->numAntenas; i++) {
+        if (gc->frequencia[i] == '#') continue; // Ignora efeitos nefastos
+        printf("Antena %c (%d,%d) -> ", gc->frequencia[i], gc->linha[i], gc->coluna[i]);
+        for (int e = gc->inicioAdj[i]; e < gc->inicioAdj[i + 1]; e++) {
+            int d = gc->destinos[e];
+            printf("(%c, %d,%d) ", gc->frequencia[d], gc->linha[d], gc->coluna[d]);
+        }
+        if (gc->frequenciasLigadas && gc->ligada[i]) {
+            int f = (unsigned char)gc->frequencia[i];
+            for (int d = gc->inicioFrequencia[f]; d < gc->inicioFrequencia[f + 1]; d++) {
+                if (d != i && gc->ligada[d]) printf("(%c, %d,%d) ", gc->frequencia[d], gc->linha[d], gc->coluna[d]);
+            }
+        }
+        printf("\n");
+    }
+    return true;
+}
+
+/**
+ * @brief Devolve o próximo vizinho por visitar de v a partir do cursor, avançando-o.
+ * @details O cursor percorre primeiro as arestas explícitas (inicioAdj[v] .. inicioAdj[v+1]-1) e depois, se v
+ *          está ligada, o grupo da sua frequência, com cursor - inicioAdj[v+1] como deslocamento no grupo.
+ *          salto[f] marca o início da parte do grupo f que ainda pode ter antenas ligadas por visitar; como as
+ *          visitas nunca se desfazem, avança sempre, e o grupo inteiro é percorrido O(k) vezes no total em vez
+ *          de uma vez por antena.
+ * @param gc Ponteiro para o grafo compacto.
+ * @param v Índice da antena.
+ * @param cursor Posição atual de v (atualizada).
+ * @param visitado Mapa de bits das antenas já visitadas.
+ * @param salto Vetor com NUM_FREQUENCIAS posições, iniciado com inicioFrequencia (atualizado).
+ * @return Índice do vizinho (pode já estar visitado se vier de uma aresta explícita), ou -1 quando não há mais.
+ */
+static int proximoVizinhoCompacto(const GrafoCompacto* gc, int v, size_t* cursor,
+                                  const unsigned char* visitado, int* salto) {
+    size_t fimExplicitas = (size_t)gc->inicioAdj[v + 1];
+    if (*cursor < fimExplicitas) return gc->destinos[(*cursor)++];
+    if (!gc->frequenciasLigadas || !gc->ligada[v]) return -1;
+
+    int f = (unsigned char)gc->frequencia[v];
+    int inicio = gc->inicioFrequencia[f];
+    int fim = gc->inicioFrequencia[f + 1];
+    while (salto[f] < fim && (!gc->ligada[salto[f]] || (visitado[salto[f] >> 3] & (1u << (salto[f] & 7)))))
+        salto[f]++;
+    int d = inicio + (int)(*cursor - fimExplicitas);
+    if (d < salto[f]) d = salto[f];
+    for (; d < fim; d++) {
+        if (d != v && gc->ligada[d] && !(visitado[d >> 3] & (1u << (d & 7)))) break;
+    }
+    *cursor = fimExplicitas + (size_t)(d - inicio) + 1;
+    return d < fim ? d : -1;
+}
+
+/**
+ * @brief DFS iterativa (pré-ordem, igual à versão recursiva) a partir de uma antena.
+ * @param gc Ponteiro para o grafo compacto.
+ * @param origem Índice da antena inicial.
+ * @param visitado Mapa de bits das antenas já visitadas (partilhado entre chamadas).
+ * @param pilha Vetor auxiliar com numAntenas posições.
+ * @param cursor Vetor auxiliar com numAntenas posições (próxima aresta a explorar, ver proximoVizinhoCompacto).
+ * @param salto Início por visitar de cada grupo de frequência (ver proximoVizinhoCompacto).
+ * @param ordem Vetor onde fica a ordem de visita, ou NULL.
+ * @param imprimir true para imprimir cada antena visitada.
+ * @return Número de antenas visitadas.
+ */
+static int percorrerCompacto(const GrafoCompacto* gc, int origem, unsigned char* visitado,
+                             int* pilha, size_t* cursor, int* salto, int* ordem, bool imprimir) {
+    int visitadas = 0;
+    int topo = 0;
+
+    visitado[origem >> 3] |= (unsigned char)(1u << (origem & 7));
+    pilha[topo++] = origem;
+    cursor[origem] = (size_t)gc->inicioAdj[origem];
+    if (ordem) ordem[visitadas] = origem;
+    visitadas++;
+    if (imprimir) printf("Antena %c (%d,%d)\n", gc->frequencia[origem], gc->linha[origem], gc->coluna[origem]);
+
+    while (topo > 0) {
+        int v = pilha[topo - 1];
+        int d = proximoVizinhoCompacto(gc, v, &cursor[v], visitado, salto);
+        if (d < 0) {
+            topo--; // Todas as arestas exploradas
+            continue;
+        }
+        if (visitado[d >> 3] & (1u << (d & 7))) continue;
+
+        visitado[d >> 3] |= (unsigned char)(1u << (d & 7));
+        pilha[topo++] = d;
+        cursor[d] = (size_t)gc->inicioAdj[d];
+        if (ordem) ordem[visitadas] = d;
+        visitadas++;
+        if (imprimir) printf("Antena %c (%d,%d)\n", gc->frequencia[d], gc->linha[d], gc->coluna[d]);
+    }
+    return visitadas;
+}
+
+/**
+ * @brief Executa uma DFS (iterativa) a partir de uma antena do grafo compacto.
+ * @param gc Ponteiro para o grafo compacto.
+ * @param origem Índice da antena inicial.
+ * @param ordem Vetor (numAntenas posições) onde fica a ordem de visita, ou NULL.
+ * @return Número de antenas visitadas, ou -1 em caso de erro.
+ */
+int DFSCompacto(const GrafoCompacto* gc, int origem, int* ordem) {
+    if (!gc || origem < 0 || origem >= gc->numAntenas) return -1;
+
+    int n = gc->numAntenas;
+    unsigned char* visitado = calloc((size_t)(n + 7) / 8, 1);
+    int* pilha = malloc((size_t)n * sizeof(int));
+    size_t* cursor = malloc((size_t)n * sizeof(size_t));
+    int salto[NUM_FREQUENCIAS];
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) salto[f] = gc->inicioFrequencia[f];
+    int visitadas = -1;
+    if (visitado && pilha && cursor)
+        visitadas = percorrerCompacto(gc, origem, visitado, pilha, cursor, salto, ordem, false);
+    free(visitado);
+    free(pilha);
+    free(cursor);
+    return visitadas;
+}
+
+/**
+ * @brief Executa DFS para todas as antenas do grafo compacto, imprimindo cada antena visitada.
+ * @param gc Ponteiro para o grafo compacto.
+ * @return true se pelo menos uma antena foi visitada, false caso contrário.
+ */
+bool DFSTraversalCompacto(const GrafoCompacto* gc) {
+    if (!gc || gc->numAntenas == 0) return false;
+
+    int n = gc->numAntenas;
+    unsigned char* visitado = calloc((size_t)(n + 7) / 8, 1);
+    int* pilha = malloc((size_t)n * sizeof(int));
+    size_t* cursor = malloc((size_t)n * sizeof(size_t));
+    int salto[NUM_FREQUENCIAS];
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) salto[f] = gc->inicioFrequencia[f];
+    bool algumVisitado = false;
+    if (visitado && pilha && cursor) {
+        for (int i = 0; i < n; i++) {
+            if (visitado[i >> 3] & (1u << (i & 7))) continue;
+            if (percorrerCompacto(gc, i, visitado, pilha, cursor, salto, NULL, true) > 0)
+                algumVisitado = true;
+        }
+    }
+    free(visitado);
+    free(pilha);
+    free(cursor);
+    return algumVisitado;
+}
+
+/**
+ * @brief Calcula todos os efeitos nefastos a partir do grafo compacto.
+ * @details Os pares são percorridos dentro de cada grupo de frequência, sobre vetores contíguos, e os nós da
+ *          lista vêm da arena do resultado. Tal como calcularResultadoEfeitos, a falta de memória (no conjunto
+ *          de posições ou na arena) liberta o resultado parcial e deixa numEfeitos a -1.
+ * @param gc Ponteiro para o grafo compacto.
+ * @param resultado Resultado a preencher (libertar com libertarEfeitos).
+ * @param status Ponteiro para bool que indica se encontrou efeitos (sempre atualizado), ou NULL.
+ * @return true se encontrou efeitos; false sem efeitos (resultado->numEfeitos == 0) ou por falta de memória
+ *         (resultado->numEfeitos == -1).
+ */
+bool calcularEfeitosCompacto(const GrafoCompacto* gc, ResultadoEfeitos* resultado, bool* status) {
+    if (status) *status = false;
+    if (!resultado) return false;
+    resultado->lista = NULL;
+    resultado->numEfeitos = 0;
+    iniciarArena(&resultado->arena, sizeof(EfeitoNefasto));
+    if (!gc || gc->numAntenas < 2) return false;
+
+    ConjuntoPosicoes vistos;
+    bool ok = iniciarConjuntoPosicoes(&vistos, gc->linhas, gc->colunas);
+    for (int f = 0; f < NUM_FREQUENCIAS && ok; f++) {
+        int inicio = gc->inicioFrequencia[f];
+        int fim = gc->inicioFrequencia[f + 1];
+        for (int i = inicio; i < fim && ok; i++) {
+            int l1 = gc->linha[i], c1 = gc->coluna[i];
+            for (int j = i + 1; j < fim && ok; j++) {
+                int efeitos[2][2];
+                int n = posicoesEfeitoPar(l1, c1, gc->linha[j], gc->coluna[j], efeitos);
+                for (int k = 0; k < n && ok; k++) {
+                    if (adicionarConjuntoPosicoes(&vistos, efeitos[k][0], efeitos[k][1])) {
+                        EfeitoNefasto* lista = inserirEfeitoArena(&resultado->arena, resultado->lista,
+                                                                  efeitos[k][0], efeitos[k][1], gc->frequencia[i]);
+                        ok = lista != resultado->lista;
+                        resultado->lista = lista;
+                    } else {
+                        // "Já existia" e falta de memória na tabela devolvem ambos false
+                        ok = pertenceConjuntoPosicoes(&vistos, efeitos[k][0], efeitos[k][1]);
+                    }
+                }
+            }
+        }
+    }
+    libertarConjuntoPosicoes(&vistos);
+    if (!ok) {
+        libertarEfeitos(resultado);
+        resultado->numEfeitos = -1;
+        return false;
+    }
+    resultado->numEfeitos = resultado->arena.numObjetos;
+    if (status) *status = resultado->lista != NULL;
+    return resultado->lista != NULL;
+}
+
+#pragma endregion
+#endif
@@ -0,0 +1,71 @@
+#ifndef COMPACTO_H
+#define COMPACTO_H
+
+#include <stdbool.h>
+#include "Dados.h"
+
+/**
+ * @file Compacto.h
+ * @brief Grafo "congelado" em formato CSR para travessias e análises só de leitura.
+ * @author João Novais
+ * @date 2025-05-18
+ */
+
+/**
+ * @brief Compila o grafo para um GrafoCompacto (CSR) só de leitura.
+ * @param g Ponteiro para o grafo.
+ * @return Ponteiro para o grafo compacto, ou NULL em caso de erro.
+ */
+GrafoCompacto* congelarGrafo(Grafo* g);
+
+/**
+ * @brief Liberta a memória de um grafo compacto.
+ * @param gc Ponteiro para o grafo compacto.
+ * @return true após libertar.
+ */
+bool libertarGrafoCompacto(GrafoCompacto* gc);
+
+/**
+ * @brief Procura o índice de uma antena no grafo compacto.
+ * @param gc Ponteiro para o grafo compacto.
+ * @param freq Frequência.
+ * @param linha Linha.
+ * @param coluna Coluna.
+ * @return Índice da antena, ou -1 se não existir.
+ */
+int procurarAntenaCompacto(const GrafoCompacto* gc, char freq, int linha, int coluna);
+
+/**
+ * @brief Imprime todas as antenas e as suas ligações do grafo compacto.
+ * @param gc Ponteiro para o grafo compacto.
+ * @return true se imprimiu, false se está vazio ou é inválido.
+ */
+bool imprimirGrafoCompacto(const GrafoCompacto* gc);
+
+/**
+ * @brief Executa uma DFS (iterativa) a partir de uma antena do grafo compacto.
+ * @param gc Ponteiro para o grafo compacto.
+ * @param origem Índice da antena inicial.
+ * @param ordem Vetor (numAntenas posições) onde fica a ordem de visita, ou NULL.
+ * @return Número de antenas visitadas, ou -1 em caso de erro.
+ */
+int DFSCompacto(const GrafoCompacto* gc, int origem, int* ordem);
+
+/**
+ * @brief Executa DFS para todas as antenas do grafo compacto, imprimindo cada antena visitada.
+ * @param gc Ponteiro para o grafo compacto.
+ * @return true se pelo menos uma antena foi visitada, false caso contrário.
+ */
+bool DFSTraversalCompacto(const GrafoCompacto* gc);
+
+/**
+ * @brief Calcula todos os efeitos nefastos a partir do grafo compacto.
+ * @param gc Ponteiro para o grafo compacto.
+ * @param resultado Resultado a preencher (libertar com libertarEfeitos).
+ * @param status Ponteiro para bool que indica se encontrou efeitos (sempre atualizado), ou NULL.
+ * @return true se encontrou efeitos; false sem efeitos (resultado->numEfeitos == 0) ou por falta de memória
+ *         (resultado->numEfeitos == -1).
+ */
+bool calcularEfeitosCompacto(const GrafoCompacto* gc, ResultadoEfeitos* resultado, bool* status);
+
+#endif
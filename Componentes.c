@@ -0,0 +1,199 @@
+#ifndef COMPONENTES_C
+#define COMPONENTES_C
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "Grafo.h"
+#include "Componentes.h"
+#include "Metricas.h"
+/**
+ * @file Componentes.c
+ * @brief Implementação da rotulagem de componentes ligadas (union-find sobre os ids densos).
+ * @author João Novais
+ * @date 2025-05-18
+ *
+ */
+
+#pragma region Componentes
+
+/**
+ * @brief Devolve a raiz do conjunto de x, comprimindo o caminho (por divisão a meio).
+ * @param pai Vetor de pais do union-find.
+ * @param x Elemento.
+ * @return Raiz do conjunto.
+ */
+static int raizConjunto(int* pai, int x) {
+    while (pai[x] != x) {
+        pai[x] = pai[pai[x]];
+        x = pai[x];
+    }
+    return x;
+}
+
+/**
+ * @brief Junta os conjuntos de a e b (união por tamanho).
+ * @param pai Vetor de pais do union-find.
+ * @param tamanho Vetor com o tamanho de cada raiz.
+ * @param a Elemento.
+ * @param b Elemento.
+ */
+static void unirConjuntos(int* pai, int* tamanho, int a, int b) {
+    a = raizConjunto(pai, a);
+    b = raizConjunto(pai, b);
+    if (a == b) return;
+    if (tamanho[a] < tamanho[b]) {
+        int t = a;
+        a = b;
+        b = t;
+    }
+    pai[b] = a;
+    tamanho[a] += tamanho[b];
+}
+
+/**
+ * @brief Corpo de rotularComponentes, sem a medição de tempo (ver rotularComponentes).
+ */
+static bool rotularComponentesInterno(Grafo* g) {
+    if (!g) return false;
+    int n = g->numAntenas;
+
+    int* pai = malloc((size_t)(n ? n : 1) * sizeof(int));
+    int* tamanho = malloc((size_t)(n ? n : 1) * sizeof(int));
+    int* tamanhos = realloc(g->tamanhosComponentes, (size_t)(n ? n : 1) * sizeof(int));
+    if (tamanhos) g->tamanhosComponentes = tamanhos;
+    VAntena** representantes = realloc(g->representantes, (size_t)(n ? n : 1) * sizeof(VAntena*));
+    if (representantes) g->representantes = representantes;
+    if (!pai || !tamanho || !tamanhos || !representantes) {
+        free(pai);
+        free(tamanho);
+        return false;
+    }
+
+    for (int i = 0; i < n; i++) {
+        pai[i] = i;
+        tamanho[i] = 1;
+    }
+    for (int i = 0; i < n; i++) {
+        for (Adjacente* adj = g->vertices[i]->listaAdj; adj != NULL; adj = adj->proximo) {
+            if (adj->destino->id >= 0) unirConjuntos(pai, tamanho, i, adj->destino->id);
+        }
+    }
+    if (g->frequenciasLigadas) {
+        for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+            BaldeFrequencia* b = &g->baldes[f];
+            int primeira = -1;
+            for (int i = 0; i < b->numAntenas; i++) {
+                if (!b->antenas[i]->ligadaFrequencia) continue;
+                if (primeira < 0) primeira = b->antenas[i]->id;
+                else unirConjuntos(pai, tamanho, primeira, b->antenas[i]->id);
+            }
+        }
+    }
+
+    // Numera as componentes pela ordem do primeiro id de cada uma (tamanho[] passa a guardar o rótulo da raiz)
+    int numComponentes = 0;
+    for (int i = 0; i < n; i++) {
+        if (raizConjunto(pai, i) == i) tamanho[i] = -1;
+    }
+    for (int i = 0; i < n; i++) {
+        int r = raizConjunto(pai, i);
+        if (tamanho[r] == -1) {
+            tamanho[r] = numComponentes;
+            g->representantes[numComponentes] = g->vertices[i];
+            g->tamanhosComponentes[numComponentes] = 0;
+            numComponentes++;
+        }
+        g->vertices[i]->componente = tamanho[r];
+        g->tamanhosComponentes[tamanho[r]]++;
+    }
+
+    free(pai);
+    free(tamanho);
+    g->numComponentes = numComponentes;
+    g->componentesValidos = true;
+    return true;
+}
+
+/**
+ * @brief Atribui a cada antena o id da sua componente ligada (ligações tratadas como não dirigidas).
+ * @details Union-find sobre as adjacências explícitas; com ligações implícitas, as antenas marcadas de cada
+ *          balde de frequência são unidas numa só passagem. Custo O(N + E) (quase linear).
+ * @param g Ponteiro para o grafo.
+ * @return true se rotulou, false em caso de erro.
+ */
+bool rotularComponentes(Grafo* g) {
+    METRICA_INICIO(inicio);
+    bool r = rotularComponentesInterno(g);
+    METRICA_FIM(g, METRICA_COMPONENTES, inicio);
+    return r;
+}
+
+/**
+ * @brief Garante que os rótulos de componentes estão atualizados.
+ * @param g Ponteiro para o grafo.
+ * @return true se os rótulos são válidos, false em caso de erro.
+ */
+static bool garantirComponentes(Grafo* g) {
+    if (!g) return false;
+    return g->componentesValidos || rotularComponentes(g);
+}
+
+/**
+ * @brief Devolve o número de componentes ligadas (rotula se necessário).
+ * @param g Ponteiro para o grafo.
+ * @return Número de componentes, ou -1 em caso de erro.
+ */
+int numeroComponentes(Grafo* g) {
+    if (!garantirComponentes(g)) return -1;
+    return g->numComponentes;
+}
+
+/**
+ * @brief Devolve o id da componente de uma antena (rotula se necessário).
+ * @param g Ponteiro para o grafo.
+ * @param ant Ponteiro para a antena.
+ * @return Id da componente (0..numComponentes-1), ou -1 em caso de erro.
+ */
+int componenteAntena(Grafo* g, VAntena* ant) {
+    if (!ant || ant->id < 0 || !garantirComponentes(g)) return -1;
+    return ant->componente;
+}
+
+/**
+ * @brief Devolve o número de antenas de uma componente.
+ * @param g Ponteiro para o grafo.
+ * @param componente Id da componente.
+ * @return Número de antenas, ou -1 se a componente não existir.
+ */
+int tamanhoComponente(Grafo* g, int componente) {
+    if (!garantirComponentes(g) || componente < 0 || componente >= g->numComponentes) return -1;
+    return g->tamanhosComponentes[componente];
+}
+
+/**
+ * @brief Devolve a antena representante de uma componente (a de menor id denso).
+ * @param g Ponteiro para o grafo.
+ * @param componente Id da componente.
+ * @return Ponteiro para a antena, ou NULL se a componente não existir.
+ */
+VAntena* representanteComponente(Grafo* g, int componente) {
+    if (!garantirComponentes(g) || componente < 0 || componente >= g->numComponentes) return NULL;
+    return g->representantes[componente];
+}
+
+/**
+ * @brief Verifica se duas antenas estão na mesma componente ligada.
+ * @details Depois da rotulagem é uma simples comparação de ids.
+ * @param g Ponteiro para o grafo.
+ * @param a Ponteiro para a primeira antena.
+ * @param b Ponteiro para a segunda antena.
+ * @return true se estão ligadas, false caso contrário.
+ */
+bool antenasLigadas(Grafo* g, VAntena* a, VAntena* b) {
+    if (!a || !b || a->id < 0 || b->id < 0 || !garantirComponentes(g)) return false;
+    return a->componente == b->componente;
+}
+
+#pragma endregion
+#endif
@@ -0,0 +1,61 @@
+#ifndef COMPONENTES_H
+#define COMPONENTES_H
+
+#include <stdbool.h>
+#include "Dados.h"
+
+/**
+ * @file Componentes.h
+ * @brief Rotulagem de componentes ligadas e consultas de alcançabilidade em tempo constante.
+ * @author João Novais
+ * @date 2025-05-18
+ */
+
+/**
+ * @brief Atribui a cada antena o id da sua componente ligada (ligações tratadas como não dirigidas).
+ * @param g Ponteiro para o grafo.
+ * @return true se rotulou, false em caso de erro.
+ */
+bool rotularComponentes(Grafo* g);
+
+/**
+ * @brief Devolve o número de componentes ligadas (rotula se necessário).
+ * @param g Ponteiro para o grafo.
+ * @return Número de componentes, ou -1 em caso de erro.
+ */
+int numeroComponentes(Grafo* g);
+
+/**
+ * @brief Devolve o id da componente de uma antena (rotula se necessário).
+ * @param g Ponteiro para o grafo.
+ * @param ant Ponteiro para a antena.
+ * @return Id da componente (0..numComponentes-1), ou -1 em caso de erro.
+ */
+int componenteAntena(Grafo* g, VAntena* ant);
+
+/**
+ * @brief Devolve o número de antenas de uma componente.
+ * @param g Ponteiro para o grafo.
+ * @param componente Id da componente.
+ * @return Número de antenas, ou -1 se a componente não existir.
+ */
+int tamanhoComponente(Grafo* g, int componente);
+
+/**
+ * @brief Devolve a antena representante de uma componente (a de menor id denso).
+ * @param g Ponteiro para o grafo.
+ * @param componente Id da componente.
+ * @return Ponteiro para a antena, ou NULL se a componente não existir.
+ */
+VAntena* representanteComponente(Grafo* g, int componente);
+
+/**
+ * @brief Verifica se duas antenas estão na mesma componente ligada.
+ * @param g Ponteiro para o grafo.
+ * @param a Ponteiro para a primeira antena.
+ * @param b Ponteiro para a segunda antena.
+ * @return true se estão ligadas, false caso contrário.
+ */
+bool antenasLigadas(Grafo* g, VAntena* a, VAntena* b);
+
+#endif
@@ -1,5 +1,10 @@
 #ifndef DADOS_H
 #define DADOS_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdatomic.h>
 /**
  * @file Dados.h
  * @brief Estruturas de dados para o grafo de antenas e efeitos nefastos.
@@ -9,6 +14,22 @@
  */
 
 
+/**
+ * @brief Arena de objetos de tamanho fixo.
+ * @details Os objetos são reservados de blocos grandes (com lista de livres para reutilização) e
+ * libertados todos de uma vez, bloco a bloco.
+ * 
+ */
+typedef struct Arena {
+    size_t tamanhoObjeto;
+    int objetosPorBloco;
+    int restantes;
+    int numObjetos;
+    void* blocos;
+    void* livres;
+    char* seguinte;
+} Arena;
+
  /**
   * @brief Estrutura para representar um grafo de antenas.
   * @details Cada antena é representada por um nó na lista ligada, e cada nó contém uma lista de adjacências.
@@ -22,6 +43,11 @@ typedef struct Adjacente {
 /**
  * @brief Estrutura para representar uma antena.
  * @details Cada antena tem uma frequência, coordenadas (linha e coluna), um indicador de visitado e uma lista de adjacências.
+ * O indicador visitado só é usado por DFS; as outras travessias guardam o estado fora das antenas, e os leitores
+ * concorrentes devem usar as versões publicadas (Versoes.h).
+ * O campo grafo aponta para o grafo dono da arena de onde a antena foi reservada (NULL se criada com malloc).
+ * ligadaFrequencia indica que a antena já existia na última chamada a conectarAntenasMesmoTipo; com ligações
+ * implícitas, só antenas marcadas são vizinhas das outras marcadas da mesma frequência.
  * 
  */
 
@@ -31,18 +57,279 @@ typedef struct VAntena {
     bool visitado;
     struct Adjacente* listaAdj;
     struct VAntena* proximo;
+    struct VAntena* anterior;
+    int posicaoBalde;
+    int id;
+    int componente;
+    bool ligadaFrequencia;
+    struct Grafo* grafo;
 } VAntena;
 
+/**
+ * @brief Entrada da tabela de dispersão de posições.
+ * @details Endereçamento aberto com sondagem linear; o estado distingue entradas livres, ocupadas e removidas.
+ * 
+ */
+typedef struct EntradaPosicao {
+    int linha, coluna;
+    unsigned char estado;
+    void* valor;
+} EntradaPosicao;
+
+/**
+ * @brief Tabela de dispersão indexada por (linha, coluna).
+ * @details A capacidade é sempre uma potência de 2 e a ocupação é mantida abaixo de metade.
+ * 
+ */
+typedef struct TabelaPosicoes {
+    EntradaPosicao* entradas;
+    int capacidade;
+    int ocupadas;
+    int removidas;
+} TabelaPosicoes;
+
+/**
+ * @brief Índice de posições das antenas.
+ * @details Mapas com limites conhecidos usam uma grelha densa (linhas x colunas); posições fora da grelha,
+ * ou mapas demasiado esparsos, ficam na tabela de dispersão.
+ * 
+ */
+typedef struct IndicePosicoes {
+    int linhas, colunas;
+    VAntena** grelha;
+    TabelaPosicoes tabela;
+} IndicePosicoes;
+
+/**
+ * @brief Conjunto de posições (linha, coluna).
+ * @details Com limites conhecidos usa um mapa de bits (um bit por célula); posições fora dos limites,
+ * ou conjuntos sem limites, ficam na tabela de dispersão.
+ * 
+ */
+typedef struct ConjuntoPosicoes {
+    int linhas, colunas;
+    unsigned char* bits;
+    TabelaPosicoes fora;
+    int numPosicoes;
+} ConjuntoPosicoes;
+
+/**
+ * @brief Conjunto das antenas de uma frequência.
+ * @details Vetor contíguo; cada antena guarda a sua posição no vetor (posicaoBalde) para remoção em tempo constante.
+ * porLinha é uma cópia ordenada por (linha, coluna), refeita só quando é precisa depois de o balde mudar
+ * (porLinhaValido passa a false em cada inserção ou remoção).
+ * 
+ */
+typedef struct BaldeFrequencia {
+    VAntena** antenas;
+    int numAntenas;
+    int capacidade;
+    VAntena** porLinha;
+    int capacidadePorLinha;
+    bool porLinhaValido;
+} BaldeFrequencia;
+
+#define NUM_FREQUENCIAS 256
+
+/**
+ * @brief Mapa de efeitos nefastos mantido incrementalmente.
+ * @details Cada tabela guarda, por posição, quantas contribuições (par de antenas, lado) produzem lá um
+ * efeito; o contador é guardado diretamente no valor (void*) da entrada. porFrequencia separa as contribuições
+ * de cada frequência; total soma todas e guarda também, no byte mais baixo do valor (contador * 256 + frequência),
+ * a menor frequência com contribuições nessa posição, para a exportação não ter de consultar as outras tabelas.
+ * 
+ */
+typedef struct EfeitosIncrementais {
+    bool ativos;
+    TabelaPosicoes total;
+    TabelaPosicoes porFrequencia[NUM_FREQUENCIAS];
+} EfeitosIncrementais;
+
+/**
+ * @brief Nó da árvore quaternária (quadtree) do índice espacial.
+ * @details Cobre o quadrado [linhaMin, linhaMin+lado) x [colunaMin, colunaMin+lado), com lado potência de 2.
+ * As folhas guardam as antenas num vetor; os nós internos têm até 4 filhos (NULL se o quadrante está vazio).
+ * frequencias é um mapa de bits (conservador: só é limpo quando o nó é refeito) das frequências presentes,
+ * para as consultas filtradas por frequência saltarem ramos inteiros.
+ * 
+ */
+typedef struct NoEspacial {
+    long long linhaMin, colunaMin, lado;
+    bool folha;
+    struct NoEspacial* filhos[4];
+    VAntena** antenas;
+    int numAntenas, capacidade;
+    int total;
+    unsigned int frequencias[NUM_FREQUENCIAS / 32];
+} NoEspacial;
+
+/**
+ * @brief Índice espacial das antenas (quadtree sobre (linha, coluna)).
+ * @details É construído na primeira consulta; a partir daí é mantido pelas inserções e remoções de antenas.
+ * 
+ */
+typedef struct IndiceEspacial {
+    NoEspacial* raiz;
+} IndiceEspacial;
+
+/**
+ * @brief Operações públicas cujo tempo é medido pela instrumentação.
+ * @details As funções públicas que não estão aqui são excluídas de propósito (ver Metricas.h).
+ * 
+ */
+typedef enum OperacaoMetrica {
+    METRICA_LER_MATRIZ,
+    METRICA_LER_ESPARSO,
+    METRICA_LER_BINARIO,
+    METRICA_GUARDAR_BINARIO,
+    METRICA_GUARDAR_BINARIO_V2,
+    METRICA_ESCREVER_MAPA,
+    METRICA_ESCREVER_ESPARSO,
+    METRICA_INSERIR_ANTENA,
+    METRICA_REMOVER_ANTENA,
+    METRICA_CONECTAR,
+    METRICA_EFEITOS,
+    METRICA_RESULTADO_EFEITOS,
+    METRICA_CONJUNTO_EFEITOS,
+    METRICA_EFEITOS_PARALELO,
+    METRICA_DFS_TRAVERSAL,
+    METRICA_CONGELAR,
+    METRICA_COMPONENTES,
+    METRICA_EFEITOS_REGIAO,
+    METRICA_EFEITOS_HARMONICOS,
+    METRICA_GUARDAR_COMPACTADO,
+    METRICA_INSERIR_LOTE,
+    METRICA_ANTENAS_RETANGULO,
+    METRICA_ANTENAS_RAIO,
+    METRICA_ANTENAS_PROXIMAS,
+    METRICA_PUBLICAR,
+    METRICA_ABRIR_DIARIO,
+    METRICA_COMPACTAR_DIARIO,
+    METRICA_EFEITOS_INCREMENTAIS,
+    NUM_OPERACOES_METRICA
+} OperacaoMetrica;
+
+/**
+ * @brief Contadores e tempos da instrumentação de um grafo.
+ * @details Só são atualizados se a biblioteca for compilada com EDA_INSTRUMENTACAO definido; caso contrário
+ * ficam a zero (a estrutura existe sempre, para o Grafo ter o mesmo formato nos dois casos).
+ * 
+ */
+typedef struct Metricas {
+    long long paresExaminados;
+    long long sondagensEfeito;
+    long long efeitosEncontrados;
+    long long verticesReservados;
+    long long adjacentesReservados;
+    long long verificacoesDuplicado;
+    long long bytesLidos;
+    long long bytesEscritos;
+    long long chamadas[NUM_OPERACOES_METRICA];
+    double segundos[NUM_OPERACOES_METRICA];
+} Metricas;
+
+/**
+ * @brief Diário (registo só de acréscimos) das alterações de um grafo persistido num ficheiro binário base.
+ * @details f é o ficheiro do diário aberto para acrescentar; numRegistos conta os registos desde a última
+ * compactação e limiteCompactacao é o número a partir do qual o diário é compactado (<= 0 para automático).
+ * ok passa a false se alguma escrita falhar (até à compactação seguinte).
+ * 
+ */
+typedef struct DiarioGrafo {
+    FILE* f;
+    char* base;
+    char* registo;
+    long long numRegistos;
+    long long limiteCompactacao;
+    bool ok;
+} DiarioGrafo;
+
 /**
  * @brief Estrutura para representar o grafo de antenas.
- * @details Contém um ponteiro para a lista de antenas e o número total de antenas.
+ * @details Contém um ponteiro para a lista de antenas, o número total de antenas,
+ * as dimensões do mapa (0 se desconhecidas), o índice de posições e as antenas agrupadas por frequência
+ * (indexadas pelo valor unsigned char da frequência). O vetor vertices dá a cada antena um id denso
+ * (0..numAntenas-1), guardado em VAntena::id. Antenas e adjacências são reservadas das arenas do grafo.
+ * Com arestasImplicitas, conectarAntenasMesmoTipo não cria nós Adjacente: marca frequenciasLigadas e as
+ * antenas existentes (VAntena::ligadaFrequencia), e as ligações entre antenas marcadas da mesma frequência
+ * passam a ser dadas pela pertença ao mesmo balde; antenas inseridas depois não ficam ligadas.
+ * Os rótulos de componentes ligadas (VAntena::componente) só são válidos com componentesValidos; qualquer
+ * alteração de vértices ou ligações invalida-os e são recalculados na consulta seguinte.
+ * Com efeitos.ativos, cada inserção/remoção de antena atualiza o mapa de efeitos só com os pares dessa antena.
+ * verbosidade controla as mensagens de diagnóstico das leituras de ficheiros (0 = nenhuma, o valor inicial).
+ * metricas acumula os contadores e tempos da instrumentação (ver Metricas.h).
+ * espacial é o índice para consultas por retângulo, raio e vizinhos mais próximos (raiz NULL até ser usado).
+ * diario, se não for NULL, recebe um registo por cada antena ligada ou desligada (ver Diario.h).
  * 
  */
 typedef struct Grafo {
     VAntena* listaAntenas;
     int numAntenas;
+    VAntena** vertices;
+    int capacidadeVertices;
+    int linhas, colunas;
+    IndicePosicoes indice;
+    BaldeFrequencia baldes[NUM_FREQUENCIAS];
+    Arena arenaVertices;
+    Arena arenaAdjacentes;
+    bool arestasImplicitas;
+    bool frequenciasLigadas;
+    bool componentesValidos;
+    int numComponentes;
+    int* tamanhosComponentes;
+    VAntena** representantes;
+    EfeitosIncrementais efeitos;
+    int verbosidade;
+    Metricas metricas;
+    IndiceEspacial espacial;
+    DiarioGrafo* diario;
 } Grafo;
 
+/**
+ * @brief Iterador sobre os vizinhos de uma antena.
+ * @details Percorre primeiro as adjacências explícitas (listaAdj) e depois, se as ligações por frequência
+ * estiverem implícitas, as restantes antenas do balde da mesma frequência.
+ * 
+ */
+typedef struct IteradorVizinhos {
+    VAntena* origem;
+    Adjacente* adj;
+    int posicaoBalde;
+    bool implicito;
+} IteradorVizinhos;
+
+
+/**
+ * @brief Registo simples de uma antena (frequência e posição), sem ligações.
+ * @details Usado para acumular antenas lidas de ficheiros antes de as inserir no grafo.
+ * 
+ */
+typedef struct RegistoAntena {
+    char frequencia;
+    int linha, coluna;
+} RegistoAntena;
+
+/**
+ * @brief Leitura em fluxo de um ficheiro binário compactado (guardarBinarioCompactado).
+ * @details O ficheiro é lido em blocos e descodificado registo a registo, sem o carregar todo em memória.
+ * soma acumula a soma de verificação dos bytes já lidos do ficheiro, que só é comparada com somaEsperada no fim.
+ * restantesGrupo, frequencia, linha e coluna são o estado da descodificação do grupo de frequência atual
+ * (inicioGrupo indica que a próxima antena do grupo é a primeira, guardada sem diferença).
+ * 
+ */
+typedef struct DescodificadorBinario {
+    FILE* f;
+    unsigned char* bloco;
+    size_t usados, posicao;
+    unsigned int soma, somaEsperada;
+    int linhas, colunas;
+    unsigned int numAntenas, lidas;
+    unsigned int restantesGrupo;
+    char frequencia;
+    int linha, coluna;
+    bool inicioGrupo;
+    bool erro;
+} DescodificadorBinario;
 
 /**
  * @brief Estrutura para representar um efeito nefasto.
@@ -55,5 +342,104 @@ typedef struct EfeitoNefasto {
     struct EfeitoNefasto* proximo;
 } EfeitoNefasto;
 
+/**
+ * @brief Resultado de um cálculo de efeitos nefastos.
+ * @details A lista é reservada de uma arena própria e libertada de uma vez com libertarEfeitos.
+ * 
+ */
+typedef struct ResultadoEfeitos {
+    EfeitoNefasto* lista;
+    int numEfeitos;
+    Arena arena;
+} ResultadoEfeitos;
+
+/**
+ * @brief Versão só de leitura do grafo em formato CSR (compressed sparse row).
+ * @details Os dados de cada antena ficam em vetores separados, ordenados por frequência e depois por
+ * (linha, coluna); as adjacências explícitas da antena i são destinos[inicioAdj[i] .. inicioAdj[i+1]-1] e as
+ * antenas da frequência f ocupam os índices inicioFrequencia[f] .. inicioFrequencia[f+1]-1.
+ * Com frequenciasLigadas, cada antena com ligada[i] é também vizinha de todas as outras com ligada[j] do seu
+ * grupo de frequência; essas ligações não são guardadas em destinos (numArestas só conta as explícitas).
+ * 
+ */
+typedef struct GrafoCompacto {
+    int numAntenas;
+    int numArestas;
+    int linhas, colunas;
+    char* frequencia;
+    int* linha;
+    int* coluna;
+    int* inicioAdj;
+    int* destinos;
+    int inicioFrequencia[NUM_FREQUENCIAS + 1];
+    bool frequenciasLigadas;
+    bool* ligada;
+} GrafoCompacto;
+
+/**
+ * @brief Versão imutável do grafo publicada para leitores concorrentes.
+ * @details O grafo compacto nunca é alterado depois de publicado; referencias conta o publicador (enquanto é a
+ * versão atual) e cada leitor que a adquiriu, e a versão é libertada quando chega a 0.
+ * 
+ */
+typedef struct VersaoGrafo {
+    GrafoCompacto* compacto;
+    unsigned long long numero;
+    atomic_int referencias;
+} VersaoGrafo;
+
+/**
+ * @brief Ponto de publicação de versões do grafo (um escritor, muitos leitores).
+ * @details atual é trocada atomicamente pelo escritor. Os leitores a meio de adquirirVersao contam-se em
+ * aAdquirir[epoca % 2]; cada publicação avança a época e espera só que a contagem da época anterior chegue a 0,
+ * para largar a versão antiga depois de esses leitores terem a sua referência. Os leitores que chegam depois
+ * contam na outra metade, por isso não atrasam o escritor.
+ * 
+ */
+typedef struct PublicadorGrafo {
+    _Atomic(VersaoGrafo*) atual;
+    atomic_uint epoca;
+    atomic_int aAdquirir[2];
+    unsigned long long proximoNumero;
+} PublicadorGrafo;
+
+
+/**
+ * @brief Ficheiros de uma tarefa do processamento em lote.
+ * @details entrada é um mapa de texto (lerMatrizAntenas); saidaMapa (escreverMapaComEfeitos) e saidaBinario
+ * (guardarBinario) podem ser NULL para não serem escritos.
+ * 
+ */
+typedef struct TarefaLote {
+    const char* entrada;
+    const char* saidaMapa;
+    const char* saidaBinario;
+} TarefaLote;
+
+/**
+ * @brief Etapa em que uma tarefa do lote falhou (LOTE_CONCLUIDA se correu tudo bem).
+ * 
+ */
+typedef enum EtapaLote {
+    LOTE_CONCLUIDA,
+    LOTE_ERRO_GRAFO,
+    LOTE_ERRO_LEITURA,
+    LOTE_ERRO_MAPA,
+    LOTE_ERRO_BINARIO
+} EtapaLote;
+
+/**
+ * @brief Resultado de uma tarefa do processamento em lote.
+ * @details segundos é o tempo total da tarefa (leitura, efeitos e escrita); trabalhador é o índice da thread
+ * que a executou.
+ * 
+ */
+typedef struct ResultadoLote {
+    EtapaLote etapa;
+    int linhas, colunas;
+    int numAntenas, numEfeitos;
+    double segundos;
+    int trabalhador;
+} ResultadoLote;
 
 #endif
\ No newline at end of file
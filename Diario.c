@@ -0,0 +1,351 @@
+#ifndef DIARIO_C
+#define DIARIO_C
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#ifdef _WIN32
+#include <windows.h>
+#endif
+#include "Antena.h"
+#include "Grafo.h"
+#include "Ficheiros.h"
+#include "Metricas.h"
+#include "Diario.h"
+/**
+ * @file Diario.c
+ * @brief Implementação da persistência com diário (registos de 10 bytes acrescentados a um ficheiro).
+ * @author João Novais
+ * @date 2025-05-18
+ *
+ */
+
+#pragma region Diario
+
+// Cabeçalho do diário: "EDAJ" seguido da versão (32 bits, little-endian)
+#define DIARIO_MAGIA "EDAJ"
+#define DIARIO_VERSAO 1u
+#define DIARIO_CABECALHO 8
+// Registo: operação, frequência, linha e coluna (32 bits, little-endian)
+#define DIARIO_REGISTO 10
+// Registos lidos de cada vez ao repetir o diário
+#define DIARIO_REGISTOS_BLOCO 6554
+// Com limite automático, o diário é compactado quando tem mais registos do que antenas (e pelo menos estes)
+#define DIARIO_REGISTOS_MINIMOS 4096
+
+/**
+ * @brief Escreve um inteiro de 32 bits em little-endian.
+ * @param p Destino (4 bytes).
+ * @param v Valor.
+ */
+static void escreverU32Diario(unsigned char* p, uint32_t v) {
+    p[0] = (unsigned char)v;
+    p[1] = (unsigned char)(v >> 8);
+    p[2] = (unsigned char)(v >> 16);
+    p[3] = (unsigned char)(v >> 24);
+}
+
+/**
+ * @brief Lê um inteiro de 32 bits em little-endian.
+ * @param p Origem (4 bytes).
+ * @return Valor lido.
+ */
+static uint32_t lerU32Diario(const unsigned char* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * @brief Junta duas cadeias numa nova (reservada com malloc).
+ * @param a Primeira cadeia.
+ * @param b Segunda cadeia.
+ * @return Nova cadeia, ou NULL em caso de erro.
+ */
+static char* juntarNomes(const char* a, const char* b) {
+    size_t na = strlen(a), nb = strlen(b);
+    char* r = malloc(na + nb + 1);
+    if (!r) return NULL;
+    memcpy(r, a, na);
+    memcpy(r + na, b, nb + 1);
+    return r;
+}
+
+/**
+ * @brief Indica se um ficheiro existe (pode ser aberto para leitura).
+ * @param filename Nome do ficheiro.
+ * @return true se existe, false caso contrário.
+ */
+static bool existeFicheiro(const char* filename) {
+    FILE* f = fopen(filename, "rb");
+    if (!f) return false;
+    fclose(f);
+    return true;
+}
+
+/**
+ * @brief Substitui atomicamente um ficheiro por outro (rename não substitui ficheiros existentes no Windows).
+ * @param origem Ficheiro novo.
+ * @param destino Ficheiro a substituir.
+ * @return true se substituiu, false caso contrário.
+ */
+static bool substituirFicheiro(const char* origem, const char* destino) {
+#ifdef _WIN32
+    return MoveFileExA(origem, destino, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    return rename(origem, destino) == 0;
+#endif
+}
+
+/**
+ * @brief Liberta a memória do diário (sem fechar o ficheiro).
+ * @param d Ponteiro para o diário.
+ */
+static void libertarDiario(DiarioGrafo* d) {
+    free(d->base);
+    free(d->registo);
+    free(d);
+}
+
+/**
+ * @brief Recomeça o ficheiro do diário só com o cabeçalho (fica aberto para acrescentar).
+ * @param d Ponteiro para o diário.
+ * @return true se escreveu, false caso contrário.
+ */
+static bool recomecarRegisto(DiarioGrafo* d) {
+    if (d->f) fclose(d->f);
+    d->f = fopen(d->registo, "wb");
+    d->numRegistos = 0;
+    unsigned char cabecalho[DIARIO_CABECALHO];
+    memcpy(cabecalho, DIARIO_MAGIA, 4);
+    escreverU32Diario(cabecalho + 4, DIARIO_VERSAO);
+    d->ok = d->f && fwrite(cabecalho, 1, DIARIO_CABECALHO, d->f) == DIARIO_CABECALHO && fflush(d->f) == 0;
+    return d->ok;
+}
+
+/**
+ * @brief Repete no grafo os registos de um diário.
+ * @details Um registo incompleto no fim (escrita interrompida) é ignorado e pede a reescrita do diário.
+ *          Repetir um diário sobre uma base que já o inclui dá o mesmo grafo (inserções em posições ocupadas
+ *          e remoções de antenas que não existem não têm efeito), por isso uma compactação interrompida entre
+ *          a troca da base e o esvaziamento do diário não perde nem duplica alterações.
+ * @param g Ponteiro para o grafo (sem diário aberto).
+ * @param filename Nome do ficheiro do diário.
+ * @param numRegistos Ponteiro onde guardar o número de registos repetidos.
+ * @param reescrever Ponteiro que fica a true se o diário tem de ser reescrito.
+ * @return true se repetiu, false se o ficheiro não é um diário válido.
+ */
+static bool repetirDiario(Grafo* g, const char* filename, long long* numRegistos, bool* reescrever) {
+    *numRegistos = 0;
+    *reescrever = false;
+    FILE* f = fopen(filename, "rb");
+    if (!f) return false;
+
+    unsigned char cabecalho[DIARIO_CABECALHO];
+    size_t lidos = fread(cabecalho, 1, DIARIO_CABECALHO, f);
+    if (lidos < DIARIO_CABECALHO) {
+        // Criado mas sem cabeçalho completo: está vazio
+        fclose(f);
+        *reescrever = true;
+        return true;
+    }
+    if (memcmp(cabecalho, DIARIO_MAGIA, 4) != 0 || lerU32Diario(cabecalho + 4) != DIARIO_VERSAO) {
+        fclose(f);
+        return false;
+    }
+
+    unsigned char* bloco = malloc((size_t)DIARIO_REGISTOS_BLOCO * DIARIO_REGISTO);
+    if (!bloco) {
+        fclose(f);
+        return false;
+    }
+    bool ok = true;
+    size_t n;
+    while (ok && (n = fread(bloco, 1, (size_t)DIARIO_REGISTOS_BLOCO * DIARIO_REGISTO, f)) > 0) {
+        METRICA_CONTAR(g, bytesLidos, (long long)n);
+        if (n % DIARIO_REGISTO != 0) *reescrever = true; // registo incompleto no fim
+        for (size_t i = 0; i + DIARIO_REGISTO <= n; i += DIARIO_REGISTO) {
+            const unsigned char* r = bloco + i;
+            char freq = (char)r[1];
+            int linha = (int)lerU32Diario(r + 2);
+            int coluna = (int)lerU32Diario(r + 6);
+            if (r[0] == DIARIO_INSERIR) inserirAntena(g, freq, linha, coluna);
+            else if (r[0] == DIARIO_REMOVER) RemoverAntena(g, freq, linha, coluna);
+            else if (r[0] == DIARIO_LIMPAR) limparGrafo(g);
+            else {
+                ok = false;
+                break;
+            }
+            (*numRegistos)++;
+        }
+    }
+    if (ferror(f)) ok = false;
+    free(bloco);
+    fclose(f);
+    return ok;
+}
+
+/**
+ * @brief Corpo de abrirDiario, sem a medição de tempo (ver abrirDiario).
+ */
+static bool abrirDiarioInterno(Grafo* g, const char* base, long long limiteCompactacao) {
+    if (!g || !base || g->diario) return false;
+    DiarioGrafo* d = (DiarioGrafo*)calloc(1, sizeof(DiarioGrafo));
+    if (!d) return false;
+    d->base = juntarNomes(base, "");
+    d->registo = juntarNomes(base, ".diario");
+    if (!d->base || !d->registo) {
+        libertarDiario(d);
+        return false;
+    }
+
+    bool temBase = existeFicheiro(d->base);
+    bool temRegisto = existeFicheiro(d->registo);
+    bool reescrever = false;
+    long long repetidos = 0;
+    bool ok = true;
+    if (temBase) ok = lerBinario(d->base, g);
+    else if (temRegisto) ok = limparGrafo(g);
+    if (ok && temRegisto) ok = repetirDiario(g, d->registo, &repetidos, &reescrever);
+    if (!ok) {
+        libertarDiario(d);
+        return false;
+    }
+
+    d->numRegistos = repetidos;
+    d->limiteCompactacao = limiteCompactacao;
+    d->ok = true;
+    g->diario = d;
+    // Sem base, ou com um registo incompleto no fim (acrescentar a seguir desalinharia os registos): compacta já
+    if (!temBase || reescrever) {
+        if (compactarDiario(g)) return true;
+    } else {
+        if (temRegisto) d->f = fopen(d->registo, "ab");
+        else recomecarRegisto(d);
+        if (d->f && confirmarDiario(g)) return true;
+    }
+    if (d->f) fclose(d->f);
+    g->diario = NULL;
+    libertarDiario(d);
+    return false;
+}
+
+/**
+ * @brief Abre o diário de um grafo: carrega a base e repete o diário (ou cria-os a partir do grafo, se não existirem).
+ * @details Se existir a base, o grafo passa a ser o da base (lerBinario) mais as alterações do diário; se só
+ *          existir o diário, é repetido sobre um grafo vazio; se não existir nenhum, o grafo atual é guardado
+ *          como base. O diário fica em base + ".diario". A partir daqui, cada antena ligada ou desligada do grafo
+ *          (inserirAntena, inserirVertice, inserirAntenasLote, RemoverAntena, removerVertice, limparGrafo) é
+ *          acrescentada ao diário em O(1). A base não guarda adjacências (voltar a ligar com conectarAntenasMesmoTipo).
+ * @param g Ponteiro para o grafo.
+ * @param base Nome do ficheiro binário base.
+ * @param limiteCompactacao Número de registos a partir do qual o diário é compactado (<= 0 para automático:
+ *        quando tiver mais registos do que antenas, o que mantém o custo amortizado de cada alteração constante).
+ * @return true se abriu, false em caso de erro.
+ */
+bool abrirDiario(Grafo* g, const char* base, long long limiteCompactacao) {
+    METRICA_INICIO(inicio);
+    bool r = abrirDiarioInterno(g, base, limiteCompactacao);
+    METRICA_FIM(g, METRICA_ABRIR_DIARIO, inicio);
+    return r;
+}
+
+/**
+ * @brief Acrescenta (em buffer) um registo ao diário do grafo, se tiver um diário aberto.
+ * @param g Ponteiro para o grafo.
+ * @param operacao DIARIO_INSERIR, DIARIO_REMOVER ou DIARIO_LIMPAR.
+ * @param ant Antena inserida ou removida (NULL para DIARIO_LIMPAR).
+ * @return true se registou (ou não há diário), false em caso de erro.
+ */
+bool registarDiario(Grafo* g, char operacao, const VAntena* ant) {
+    if (!g) return false;
+    DiarioGrafo* d = g->diario;
+    if (!d) return true;
+
+    unsigned char r[DIARIO_REGISTO] = { 0 };
+    r[0] = (unsigned char)operacao;
+    if (ant) {
+        r[1] = (unsigned char)ant->frequencia;
+        escreverU32Diario(r + 2, (uint32_t)ant->linha);
+        escreverU32Diario(r + 6, (uint32_t)ant->coluna);
+    }
+    if (!d->f || fwrite(r, 1, DIARIO_REGISTO, d->f) != DIARIO_REGISTO) {
+        d->ok = false;
+        return false;
+    }
+    d->numRegistos++;
+    METRICA_CONTAR(g, bytesEscritos, DIARIO_REGISTO);
+    return true;
+}
+
+/**
+ * @brief Escreve no ficheiro os registos em buffer e compacta o diário se passou do limite.
+ * @param g Ponteiro para o grafo.
+ * @return true se o diário está em dia (ou não há diário), false se alguma escrita falhou.
+ */
+bool confirmarDiario(Grafo* g) {
+    if (!g) return false;
+    DiarioGrafo* d = g->diario;
+    if (!d) return true;
+    if (!d->f || fflush(d->f) != 0) d->ok = false;
+
+    long long limite = d->limiteCompactacao;
+    if (limite <= 0) limite = g->numAntenas > DIARIO_REGISTOS_MINIMOS ? g->numAntenas : DIARIO_REGISTOS_MINIMOS;
+    if (d->numRegistos >= limite) compactarDiario(g); // se falhar, o diário continua a crescer
+    return d->ok;
+}
+
+/**
+ * @brief Corpo de compactarDiario, sem a medição de tempo (ver compactarDiario).
+ */
+static bool compactarDiarioInterno(Grafo* g) {
+    if (!g || !g->diario) return false;
+    DiarioGrafo* d = g->diario;
+    char* temporario = juntarNomes(d->base, ".tmp");
+    if (!temporario) return false;
+
+    if (d->f) fflush(d->f);
+    if (!guardarBinarioV2(temporario, g, false) || !substituirFicheiro(temporario, d->base)) {
+        remove(temporario);
+        free(temporario);
+        return false;
+    }
+    free(temporario);
+
+    // A base já tem tudo: recomeça o diário só com o cabeçalho
+    return recomecarRegisto(d);
+}
+
+/**
+ * @brief Compacta o diário: guarda o grafo numa nova base e esvazia o diário.
+ * @details A nova base é escrita num ficheiro temporário que depois substitui a anterior; só então o diário é
+ *          esvaziado. Se a compactação for interrompida, abrirDiario recupera o mesmo grafo (ver repetirDiario).
+ *          Uma compactação bem sucedida repõe o diário em dia mesmo que escritas anteriores tenham falhado.
+ * @param g Ponteiro para o grafo.
+ * @return true se compactou, false em caso de erro (a base e o diário anteriores continuam válidos).
+ */
+bool compactarDiario(Grafo* g) {
+    METRICA_INICIO(inicio);
+    bool r = compactarDiarioInterno(g);
+    METRICA_FIM(g, METRICA_COMPACTAR_DIARIO, inicio);
+    return r;
+}
+
+/**
+ * @brief Fecha o diário do grafo (os ficheiros ficam prontos para voltar a ser abertos com abrirDiario).
+ * @param g Ponteiro para o grafo.
+ * @return true se todas as escritas do diário tiveram sucesso, false caso contrário.
+ */
+bool fecharDiario(Grafo* g) {
+    if (!g || !g->diario) return false;
+    DiarioGrafo* d = g->diario;
+    bool ok = d->ok;
+    if (!d->f || fclose(d->f) != 0) ok = false;
+    g->diario = NULL;
+    libertarDiario(d);
+    return ok;
+}
+
+#pragma endregion
+
+#endif
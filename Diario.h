@@ -0,0 +1,60 @@
+#ifndef DIARIO_H
+#define DIARIO_H
+
+#include <stdbool.h>
+#include "Dados.h"
+
+/**
+ * @file Diario.h
+ * @brief Persistência com diário: ficheiro binário base mais um registo só de acréscimos, compactado periodicamente.
+ * @author João Novais
+ * @date 2025-05-18
+ */
+
+// Operações guardadas no diário
+#define DIARIO_INSERIR '+'
+#define DIARIO_REMOVER '-'
+#define DIARIO_LIMPAR 'L'
+
+/**
+ * @brief Abre o diário de um grafo: carrega a base e repete o diário (ou cria-os a partir do grafo, se não existirem).
+ * @details O diário fica em base + ".diario". A partir daqui, cada antena ligada ou desligada do grafo
+ *          é acrescentada ao diário.
+ * @param g Ponteiro para o grafo.
+ * @param base Nome do ficheiro binário base.
+ * @param limiteCompactacao Número de registos a partir do qual o diário é compactado (<= 0 para automático).
+ * @return true se abriu, false em caso de erro.
+ */
+bool abrirDiario(Grafo* g, const char* base, long long limiteCompactacao);
+
+/**
+ * @brief Acrescenta (em buffer) um registo ao diário do grafo, se tiver um diário aberto.
+ * @param g Ponteiro para o grafo.
+ * @param operacao DIARIO_INSERIR, DIARIO_REMOVER ou DIARIO_LIMPAR.
+ * @param ant Antena inserida ou removida (NULL para DIARIO_LIMPAR).
+ * @return true se registou (ou não há diário), false em caso de erro.
+ */
+bool registarDiario(Grafo* g, char operacao, const VAntena* ant);
+
+/**
+ * @brief Escreve no ficheiro os registos em buffer e compacta o diário se passou do limite.
+ * @param g Ponteiro para o grafo.
+ * @return true se o diário está em dia (ou não há diário), false se alguma escrita falhou.
+ */
+bool confirmarDiario(Grafo* g);
+
+/**
+ * @brief Compacta o diário: guarda o grafo numa nova base e esvazia o diário.
+ * @param g Ponteiro para o grafo.
+ * @return true se compactou, false em caso de erro (a base e o diário anteriores continuam válidos).
+ */
+bool compactarDiario(Grafo* g);
+
+/**
+ * @brief Fecha o diário do grafo (os ficheiros ficam prontos para voltar a ser abertos com abrirDiario).
+ * @param g Ponteiro para o grafo.
+ * @return true se todas as escritas do diário tiveram sucesso, false caso contrário.
+ */
+bool fecharDiario(Grafo* g);
+
+#endif
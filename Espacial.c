@@ -0,0 +1,664 @@
+#ifndef ESPACIAL_C
+#define ESPACIAL_C
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include "Espacial.h"
+#include "Metricas.h"
+/**
+ * @file Espacial.c
+ * @brief Implementação do índice espacial (quadtree) e das consultas por retângulo, raio e k vizinhos.
+ * @author João Novais
+ * @date 2025-05-18
+ *
+ */
+
+// Número máximo de antenas numa folha antes de a dividir (folhas de lado 1 não se dividem)
+#define ESPACIAL_CAPACIDADE 16
+
+/**
+ * @brief Vetor dinâmico com o resultado de uma consulta.
+ */
+typedef struct ResultadoEspacial {
+    VAntena** antenas;
+    int num, capacidade;
+} ResultadoEspacial;
+
+/**
+ * @brief Elemento da fila de prioridade da pesquisa dos k vizinhos (um nó ou uma antena).
+ */
+typedef struct CandidatoEspacial {
+    long long distancia2;
+    NoEspacial* no;
+    VAntena* antena;
+} CandidatoEspacial;
+
+#pragma region Nos
+
+/**
+ * @brief Cria uma folha vazia que cobre o quadrado dado.
+ * @param linhaMin Primeira linha.
+ * @param colunaMin Primeira coluna.
+ * @param lado Lado do quadrado (potência de 2).
+ * @return Ponteiro para o nó, ou NULL em caso de erro.
+ */
+static NoEspacial* criarNoEspacial(long long linhaMin, long long colunaMin, long long lado) {
+    NoEspacial* no = (NoEspacial*)calloc(1, sizeof(NoEspacial));
+    if (!no) return NULL;
+    no->linhaMin = linhaMin;
+    no->colunaMin = colunaMin;
+    no->lado = lado;
+    no->folha = true;
+    return no;
+}
+
+/**
+ * @brief Liberta um nó e toda a sua subárvore.
+ * @param no Ponteiro para o nó.
+ */
+static void libertarNoEspacial(NoEspacial* no) {
+    if (!no) return;
+    for (int q = 0; q < 4; q++) libertarNoEspacial(no->filhos[q]);
+    free(no->antenas);
+    free(no);
+}
+
+/**
+ * @brief Marca uma frequência no mapa de bits de um nó.
+ * @param no Ponteiro para o nó.
+ * @param freq Frequência.
+ */
+static void marcarFrequencia(NoEspacial* no, char freq) {
+    unsigned char f = (unsigned char)freq;
+    no->frequencias[f >> 5] |= 1u << (f & 31);
+}
+
+/**
+ * @brief Indica se um nó pode conter antenas de uma frequência.
+ * @param no Ponteiro para o nó.
+ * @param freq Frequência ou QUALQUER_FREQUENCIA.
+ * @return true se pode conter, false se de certeza não contém.
+ */
+static bool temFrequencia(const NoEspacial* no, int freq) {
+    if (freq == QUALQUER_FREQUENCIA) return true;
+    return (no->frequencias[freq >> 5] >> (freq & 31)) & 1u;
+}
+
+/**
+ * @brief Indica em que quadrante de um nó fica uma posição.
+ * @param no Ponteiro para o nó.
+ * @param linha Linha.
+ * @param coluna Coluna.
+ * @return Índice do quadrante (0..3).
+ */
+static int quadrante(const NoEspacial* no, long long linha, long long coluna) {
+    long long meio = no->lado / 2;
+    return (linha >= no->linhaMin + meio ? 2 : 0) + (coluna >= no->colunaMin + meio ? 1 : 0);
+}
+
+/**
+ * @brief Indica se uma posição está dentro do quadrado de um nó.
+ * @param no Ponteiro para o nó.
+ * @param linha Linha.
+ * @param coluna Coluna.
+ * @return true se está dentro, false caso contrário.
+ */
+static bool dentroNo(const NoEspacial* no, long long linha, long long coluna) {
+    return linha >= no->linhaMin && linha < no->linhaMin + no->lado &&
+           coluna >= no->colunaMin && coluna < no->colunaMin + no->lado;
+}
+
+/**
+ * @brief Acrescenta uma antena ao vetor de uma folha.
+ * @param no Ponteiro para a folha.
+ * @param ant Ponteiro para a antena.
+ * @return true se acrescentou, false em caso de erro de memória.
+ */
+static bool acrescentarFolha(NoEspacial* no, VAntena* ant) {
+    if (no->numAntenas == no->capacidade) {
+        int capacidade = no->capacidade ? no->capacidade * 2 : ESPACIAL_CAPACIDADE;
+        VAntena** novo = realloc(no->antenas, (size_t)capacidade * sizeof(VAntena*));
+        if (!novo) return false;
+        no->antenas = novo;
+        no->capacidade = capacidade;
+    }
+    no->antenas[no->numAntenas++] = ant;
+    return true;
+}
+
+/**
+ * @brief Insere uma antena na subárvore de um nó (que a tem de cobrir), dividindo folhas cheias.
+ * @param no Ponteiro para o nó.
+ * @param ant Ponteiro para a antena.
+ * @return true se inseriu, false em caso de erro de memória (a árvore fica inconsistente).
+ */
+static bool inserirNoEspacial(NoEspacial* no, VAntena* ant) {
+    no->total++;
+    marcarFrequencia(no, ant->frequencia);
+    if (no->folha) {
+        if (!acrescentarFolha(no, ant)) return false;
+        if (no->numAntenas <= ESPACIAL_CAPACIDADE || no->lado == 1) return true;
+
+        // Divide a folha: as antenas passam para os quadrantes
+        VAntena** antenas = no->antenas;
+        int num = no->numAntenas;
+        no->antenas = NULL;
+        no->numAntenas = no->capacidade = 0;
+        no->folha = false;
+        no->total -= num;
+        bool ok = true;
+        for (int i = 0; i < num && ok; i++) {
+            no->total++;
+            int q = quadrante(no, antenas[i]->linha, antenas[i]->coluna);
+            if (!no->filhos[q]) {
+                long long meio = no->lado / 2;
+                no->filhos[q] = criarNoEspacial(no->linhaMin + (q & 2 ? meio : 0),
+                                                no->colunaMin + (q & 1 ? meio : 0), meio);
+                if (!no->filhos[q]) ok = false;
+            }
+            if (ok) ok = inserirNoEspacial(no->filhos[q], antenas[i]);
+        }
+        free(antenas);
+        return ok;
+    }
+
+    int q = quadrante(no, ant->linha, ant->coluna);
+    if (!no->filhos[q]) {
+        long long meio = no->lado / 2;
+        no->filhos[q] = criarNoEspacial(no->linhaMin + (q & 2 ? meio : 0),
+                                        no->colunaMin + (q & 1 ? meio : 0), meio);
+        if (!no->filhos[q]) return false;
+    }
+    return inserirNoEspacial(no->filhos[q], ant);
+}
+
+/**
+ * @brief Junta na folha no todas as antenas da subárvore de origem, libertando os nós de origem.
+ * @param no Folha de destino (já com vetor reservado para todas as antenas).
+ * @param origem Nó a esvaziar.
+ */
+static void recolherNoEspacial(NoEspacial* no, NoEspacial* origem) {
+    if (origem->folha) {
+        for (int i = 0; i < origem->numAntenas; i++) {
+            no->antenas[no->numAntenas++] = origem->antenas[i];
+            marcarFrequencia(no, origem->antenas[i]->frequencia);
+        }
+    } else {
+        for (int q = 0; q < 4; q++)
+            if (origem->filhos[q]) recolherNoEspacial(no, origem->filhos[q]);
+    }
+    if (origem != no) {
+        free(origem->antenas);
+        free(origem);
+    }
+}
+
+/**
+ * @brief Retira uma antena da subárvore de um nó, juntando de novo numa folha os nós com poucas antenas.
+ * @param no Ponteiro para o nó.
+ * @param ant Ponteiro para a antena.
+ * @return true se retirou, false se a antena não estava na subárvore.
+ */
+static bool retirarNoEspacial(NoEspacial* no, VAntena* ant) {
+    if (no->folha) {
+        for (int i = 0; i < no->numAntenas; i++) {
+            if (no->antenas[i] != ant) continue;
+            no->antenas[i] = no->antenas[--no->numAntenas];
+            no->total--;
+            return true;
+        }
+        return false;
+    }
+
+    int q = quadrante(no, ant->linha, ant->coluna);
+    if (!no->filhos[q] || !retirarNoEspacial(no->filhos[q], ant)) return false;
+    no->total--;
+    if (no->filhos[q]->total == 0) {
+        libertarNoEspacial(no->filhos[q]);
+        no->filhos[q] = NULL;
+    }
+    if (no->total > ESPACIAL_CAPACIDADE) return true;
+
+    // Poucas antenas: o nó volta a ser folha (e o mapa de frequências fica exato)
+    VAntena** antenas = (VAntena**)malloc((size_t)ESPACIAL_CAPACIDADE * sizeof(VAntena*));
+    if (!antenas) return true; // continua válido como nó interno
+    memset(no->frequencias, 0, sizeof(no->frequencias));
+    NoEspacial* filhos[4];
+    memcpy(filhos, no->filhos, sizeof(filhos));
+    memset(no->filhos, 0, sizeof(no->filhos));
+    no->antenas = antenas;
+    no->capacidade = ESPACIAL_CAPACIDADE;
+    no->numAntenas = 0;
+    no->folha = true;
+    for (int i = 0; i < 4; i++)
+        if (filhos[i]) recolherNoEspacial(no, filhos[i]);
+    return true;
+}
+
+/**
+ * @brief Aumenta a raiz (duplicando o lado) até cobrir uma posição.
+ * @param g Ponteiro para o grafo.
+ * @param linha Linha.
+ * @param coluna Coluna.
+ * @return true se a raiz cobre a posição, false em caso de erro de memória.
+ */
+static bool cobrirPosicao(Grafo* g, long long linha, long long coluna) {
+    NoEspacial* raiz = g->espacial.raiz;
+    while (!dentroNo(raiz, linha, coluna)) {
+        // Cresce para o lado da posição; a raiz antiga passa a ser um quadrante da nova
+        long long linhaMin = linha < raiz->linhaMin ? raiz->linhaMin - raiz->lado : raiz->linhaMin;
+        long long colunaMin = coluna < raiz->colunaMin ? raiz->colunaMin - raiz->lado : raiz->colunaMin;
+        NoEspacial* nova = criarNoEspacial(linhaMin, colunaMin, raiz->lado * 2);
+        if (!nova) return false;
+        nova->folha = false;
+        nova->total = raiz->total;
+        memcpy(nova->frequencias, raiz->frequencias, sizeof(nova->frequencias));
+        if (raiz->total > 0)
+            nova->filhos[quadrante(nova, raiz->linhaMin, raiz->colunaMin)] = raiz;
+        else
+            libertarNoEspacial(raiz);
+        g->espacial.raiz = raiz = nova;
+    }
+    return true;
+}
+
+#pragma endregion
+
+#pragma region Manutencao
+
+/**
+ * @brief Constrói o índice espacial com todas as antenas do grafo (se ainda não existir).
+ * @details A raiz começa no menor quadrado (lado potência de 2) que cobre as antenas atuais e cresce quando
+ *          for preciso. Depois de construído, o índice é mantido por registarVertice/retirarVertice.
+ * @param g Ponteiro para o grafo.
+ * @return true se o índice está pronto, false em caso de erro de memória.
+ */
+bool construirIndiceEspacial(Grafo* g) {
+    if (!g) return false;
+    if (g->espacial.raiz) return true;
+
+    long long linhaMin = 0, colunaMin = 0, linhaMax = 0, colunaMax = 0;
+    for (int i = 0; i < g->numAntenas; i++) {
+        VAntena* a = g->vertices[i];
+        if (i == 0 || a->linha < linhaMin) linhaMin = a->linha;
+        if (i == 0 || a->coluna < colunaMin) colunaMin = a->coluna;
+        if (i == 0 || a->linha > linhaMax) linhaMax = a->linha;
+        if (i == 0 || a->coluna > colunaMax) colunaMax = a->coluna;
+    }
+    long long extensao = linhaMax - linhaMin > colunaMax - colunaMin ? linhaMax - linhaMin : colunaMax - colunaMin;
+    long long lado = 1;
+    while (lado <= extensao) lado *= 2;
+
+    g->espacial.raiz = criarNoEspacial(linhaMin, colunaMin, lado);
+    if (!g->espacial.raiz) return false;
+    for (int i = 0; i < g->numAntenas; i++) {
+        if (!inserirNoEspacial(g->espacial.raiz, g->vertices[i])) {
+            libertarIndiceEspacial(g);
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Liberta o índice espacial (volta a ser construído na próxima consulta).
+ * @param g Ponteiro para o grafo.
+ * @return true após libertar.
+ */
+bool libertarIndiceEspacial(Grafo* g) {
+    if (!g) return false;
+    libertarNoEspacial(g->espacial.raiz);
+    g->espacial.raiz = NULL;
+    return true;
+}
+
+/**
+ * @brief Acrescenta uma antena ao índice espacial, se este já estiver construído.
+ * @param g Ponteiro para o grafo.
+ * @param ant Ponteiro para a antena.
+ * @return true se acrescentou (ou não há índice), false se faltou memória (o índice é então descartado).
+ */
+bool registarEspacial(Grafo* g, VAntena* ant) {
+    if (!g || !ant) return false;
+    if (!g->espacial.raiz) return true;
+    if (!cobrirPosicao(g, ant->linha, ant->coluna) || !inserirNoEspacial(g->espacial.raiz, ant)) {
+        // Sem memória a árvore pode ficar incompleta: descarta-a e reconstrói na próxima consulta
+        libertarIndiceEspacial(g);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Retira uma antena do índice espacial, se este já estiver construído.
+ * @param g Ponteiro para o grafo.
+ * @param ant Ponteiro para a antena.
+ * @return true se retirou (ou não há índice), false se a antena não estava no índice.
+ */
+bool retirarEspacial(Grafo* g, VAntena* ant) {
+    if (!g || !ant) return false;
+    if (!g->espacial.raiz) return true;
+    if (!dentroNo(g->espacial.raiz, ant->linha, ant->coluna)) return false;
+    return retirarNoEspacial(g->espacial.raiz, ant);
+}
+
+#pragma endregion
+
+#pragma region Consultas
+
+/**
+ * @brief Acrescenta uma antena ao resultado de uma consulta.
+ * @param r Ponteiro para o resultado.
+ * @param ant Ponteiro para a antena.
+ * @return true se acrescentou, false em caso de erro de memória.
+ */
+static bool acrescentarResultado(ResultadoEspacial* r, VAntena* ant) {
+    if (r->num == r->capacidade) {
+        int capacidade = r->capacidade ? r->capacidade * 2 : 16;
+        VAntena** novo = realloc(r->antenas, (size_t)capacidade * sizeof(VAntena*));
+        if (!novo) return false;
+        r->antenas = novo;
+        r->capacidade = capacidade;
+    }
+    r->antenas[r->num++] = ant;
+    return true;
+}
+
+/**
+ * @brief Devolve o vetor de um resultado (ou NULL se vazio), libertando-o em caso de erro.
+ * @param r Ponteiro para o resultado.
+ * @param ok false se a consulta falhou.
+ * @param num Ponteiro onde guardar o número de antenas.
+ * @return Vetor de antenas, ou NULL.
+ */
+static VAntena** entregarResultado(ResultadoEspacial* r, bool ok, int* num) {
+    if (!ok || r->num == 0) {
+        free(r->antenas);
+        *num = 0;
+        return NULL;
+    }
+    *num = r->num;
+    return r->antenas;
+}
+
+/**
+ * @brief Distância euclidiana ao quadrado de uma posição ao quadrado coberto por um nó (0 se estiver dentro).
+ * @param no Ponteiro para o nó.
+ * @param linha Linha.
+ * @param coluna Coluna.
+ * @return Distância ao quadrado.
+ */
+static long long distanciaNo(const NoEspacial* no, long long linha, long long coluna) {
+    long long dl = 0, dc = 0;
+    if (linha < no->linhaMin) dl = no->linhaMin - linha;
+    else if (linha > no->linhaMin + no->lado - 1) dl = linha - (no->linhaMin + no->lado - 1);
+    if (coluna < no->colunaMin) dc = no->colunaMin - coluna;
+    else if (coluna > no->colunaMin + no->lado - 1) dc = coluna - (no->colunaMin + no->lado - 1);
+    return dl * dl + dc * dc;
+}
+
+/**
+ * @brief Distância euclidiana ao quadrado de uma posição a uma antena.
+ * @param ant Ponteiro para a antena.
+ * @param linha Linha.
+ * @param coluna Coluna.
+ * @return Distância ao quadrado.
+ */
+static long long distanciaAntena(const VAntena* ant, long long linha, long long coluna) {
+    long long dl = ant->linha - linha, dc = ant->coluna - coluna;
+    return dl * dl + dc * dc;
+}
+
+/**
+ * @brief Percorre a subárvore de um nó, recolhendo as antenas dentro de um retângulo.
+ * @param no Ponteiro para o nó.
+ * @param linhaMin Primeira linha.
+ * @param colunaMin Primeira coluna.
+ * @param linhaMax Última linha.
+ * @param colunaMax Última coluna.
+ * @param freq Frequência ou QUALQUER_FREQUENCIA.
+ * @param r Ponteiro para o resultado.
+ * @return true se percorreu, false em caso de erro de memória.
+ */
+static bool consultarRetangulo(const NoEspacial* no, long long linhaMin, long long colunaMin,
+                               long long linhaMax, long long colunaMax, int freq, ResultadoEspacial* r) {
+    if (!no || no->total == 0 || !temFrequencia(no, freq)) return true;
+    if (no->linhaMin > linhaMax || no->linhaMin + no->lado - 1 < linhaMin ||
+        no->colunaMin > colunaMax || no->colunaMin + no->lado - 1 < colunaMin) return true;
+    if (no->folha) {
+        for (int i = 0; i < no->numAntenas; i++) {
+            VAntena* a = no->antenas[i];
+            if (a->linha < linhaMin || a->linha > linhaMax || a->coluna < colunaMin || a->coluna > colunaMax) continue;
+            if (freq != QUALQUER_FREQUENCIA && (unsigned char)a->frequencia != freq) continue;
+            if (!acrescentarResultado(r, a)) return false;
+        }
+        return true;
+    }
+    for (int q = 0; q < 4; q++)
+        if (!consultarRetangulo(no->filhos[q], linhaMin, colunaMin, linhaMax, colunaMax, freq, r)) return false;
+    return true;
+}
+
+/**
+ * @brief Percorre a subárvore de um nó, recolhendo as antenas a distância ao quadrado não superior a raio2.
+ * @param no Ponteiro para o nó.
+ * @param linha Linha do centro.
+ * @param coluna Coluna do centro.
+ * @param raio2 Raio ao quadrado.
+ * @param freq Frequência ou QUALQUER_FREQUENCIA.
+ * @param r Ponteiro para o resultado.
+ * @return true se percorreu, false em caso de erro de memória.
+ */
+static bool consultarRaio(const NoEspacial* no, long long linha, long long coluna, double raio2, int freq,
+                          ResultadoEspacial* r) {
+    if (!no || no->total == 0 || !temFrequencia(no, freq)) return true;
+    if ((double)distanciaNo(no, linha, coluna) > raio2) return true;
+    if (no->folha) {
+        for (int i = 0; i < no->numAntenas; i++) {
+            VAntena* a = no->antenas[i];
+            if (freq != QUALQUER_FREQUENCIA && (unsigned char)a->frequencia != freq) continue;
+            if ((double)distanciaAntena(a, linha, coluna) > raio2) continue;
+            if (!acrescentarResultado(r, a)) return false;
+        }
+        return true;
+    }
+    for (int q = 0; q < 4; q++)
+        if (!consultarRaio(no->filhos[q], linha, coluna, raio2, freq, r)) return false;
+    return true;
+}
+
+/**
+ * @brief Corpo de antenasRetangulo, sem a medição de tempo (ver antenasRetangulo).
+ */
+static VAntena** antenasRetanguloInterno(Grafo* g, int linhaMin, int colunaMin,
+                                          int linhaMax, int colunaMax, int freq, int* num) {
+    if (!num) return NULL;
+    *num = 0;
+    if (!g || freq < QUALQUER_FREQUENCIA || freq >= NUM_FREQUENCIAS) return NULL;
+    if (linhaMin > linhaMax || colunaMin > colunaMax) return NULL;
+    if (!construirIndiceEspacial(g)) return NULL;
+
+    ResultadoEspacial r = { NULL, 0, 0 };
+    bool ok = consultarRetangulo(g->espacial.raiz, linhaMin, colunaMin, linhaMax, colunaMax, freq, &r);
+    return entregarResultado(&r, ok, num);
+}
+
+/**
+ * @brief Devolve as antenas dentro de um retângulo (limites incluídos).
+ * @param g Ponteiro para o grafo.
+ * @param linhaMin Primeira linha.
+ * @param colunaMin Primeira coluna.
+ * @param linhaMax Última linha.
+ * @param colunaMax Última coluna.
+ * @param freq Frequência (valor unsigned char) ou QUALQUER_FREQUENCIA.
+ * @param num Ponteiro onde guardar o número de antenas encontradas.
+ * @return Vetor de antenas (libertar com free), ou NULL se não houver nenhuma ou em caso de erro.
+ */
+VAntena** antenasRetangulo(Grafo* g, int linhaMin, int colunaMin, int linhaMax, int colunaMax, int freq, int* num) {
+    METRICA_INICIO(inicio);
+    VAntena** r = antenasRetanguloInterno(g, linhaMin, colunaMin, linhaMax, colunaMax, freq, num);
+    METRICA_FIM(g, METRICA_ANTENAS_RETANGULO, inicio);
+    return r;
+}
+
+/**
+ * @brief Corpo de antenasRaio, sem a medição de tempo (ver antenasRaio).
+ */
+static VAntena** antenasRaioInterno(Grafo* g, int linha, int coluna, double raio, int freq, int* num) {
+    if (!num) return NULL;
+    *num = 0;
+    if (!g || freq < QUALQUER_FREQUENCIA || freq >= NUM_FREQUENCIAS || !(raio >= 0)) return NULL;
+    if (!construirIndiceEspacial(g)) return NULL;
+
+    ResultadoEspacial r = { NULL, 0, 0 };
+    bool ok = consultarRaio(g->espacial.raiz, linha, coluna, raio * raio, freq, &r);
+    return entregarResultado(&r, ok, num);
+}
+
+/**
+ * @brief Devolve as antenas a distância (euclidiana) não superior a raio de uma posição.
+ * @param g Ponteiro para o grafo.
+ * @param linha Linha do centro.
+ * @param coluna Coluna do centro.
+ * @param raio Raio.
+ * @param freq Frequência (valor unsigned char) ou QUALQUER_FREQUENCIA.
+ * @param num Ponteiro onde guardar o número de antenas encontradas.
+ * @return Vetor de antenas (libertar com free), ou NULL se não houver nenhuma ou em caso de erro.
+ */
+VAntena** antenasRaio(Grafo* g, int linha, int coluna, double raio, int freq, int* num) {
+    METRICA_INICIO(inicio);
+    VAntena** r = antenasRaioInterno(g, linha, coluna, raio, freq, num);
+    METRICA_FIM(g, METRICA_ANTENAS_RAIO, inicio);
+    return r;
+}
+
+/**
+ * @brief Ordem da fila de prioridade: menor distância primeiro; em empate, antenas antes de nós e por id.
+ * @param a Primeiro candidato.
+ * @param b Segundo candidato.
+ * @return true se a deve sair antes de b.
+ */
+static bool antesCandidato(const CandidatoEspacial* a, const CandidatoEspacial* b) {
+    if (a->distancia2 != b->distancia2) return a->distancia2 < b->distancia2;
+    if (!a->antena || !b->antena) return a->antena != NULL && b->antena == NULL;
+    return a->antena->id < b->antena->id;
+}
+
+/**
+ * @brief Acrescenta um candidato à fila de prioridade (heap binário).
+ * @param fila Ponteiro para o vetor da fila.
+ * @param num Ponteiro para o número de elementos.
+ * @param capacidade Ponteiro para a capacidade.
+ * @param c Candidato.
+ * @return true se acrescentou, false em caso de erro de memória.
+ */
+static bool empilharCandidato(CandidatoEspacial** fila, int* num, int* capacidade, CandidatoEspacial c) {
+    if (*num == *capacidade) {
+        int nova = *capacidade ? *capacidade * 2 : 64;
+        CandidatoEspacial* novo = realloc(*fila, (size_t)nova * sizeof(CandidatoEspacial));
+        if (!novo) return false;
+        *fila = novo;
+        *capacidade = nova;
+    }
+    CandidatoEspacial* h = *fila;
+    int i = (*num)++;
+    while (i > 0 && antesCandidato(&c, &h[(i - 1) / 2])) {
+        h[i] = h[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    h[i] = c;
+    return true;
+}
+
+/**
+ * @brief Retira o primeiro candidato da fila de prioridade (que não pode estar vazia).
+ * @param fila Vetor da fila.
+ * @param num Ponteiro para o número de elementos.
+ * @return Candidato retirado.
+ */
+static CandidatoEspacial desempilharCandidato(CandidatoEspacial* fila, int* num) {
+    CandidatoEspacial primeiro = fila[0];
+    CandidatoEspacial ultimo = fila[--(*num)];
+    int i = 0;
+    for (;;) {
+        int filho = 2 * i + 1;
+        if (filho >= *num) break;
+        if (filho + 1 < *num && antesCandidato(&fila[filho + 1], &fila[filho])) filho++;
+        if (!antesCandidato(&fila[filho], &ultimo)) break;
+        fila[i] = fila[filho];
+        i = filho;
+    }
+    if (*num > 0) fila[i] = ultimo;
+    return primeiro;
+}
+
+/**
+ * @brief Corpo de antenasMaisProximas, sem a medição de tempo (ver antenasMaisProximas).
+ */
+static VAntena** antenasMaisProximasInterno(Grafo* g, int linha, int coluna, int k, int freq, int* num) {
+    if (!num) return NULL;
+    *num = 0;
+    if (!g || k <= 0 || freq < QUALQUER_FREQUENCIA || freq >= NUM_FREQUENCIAS) return NULL;
+    if (!construirIndiceEspacial(g)) return NULL;
+
+    ResultadoEspacial r = { NULL, 0, 0 };
+    CandidatoEspacial* fila = NULL;
+    int numFila = 0, capacidadeFila = 0;
+    NoEspacial* raiz = g->espacial.raiz;
+    bool ok = true;
+    if (raiz->total > 0 && temFrequencia(raiz, freq)) {
+        CandidatoEspacial c = { distanciaNo(raiz, linha, coluna), raiz, NULL };
+        ok = empilharCandidato(&fila, &numFila, &capacidadeFila, c);
+    }
+    while (ok && numFila > 0 && r.num < k) {
+        CandidatoEspacial atual = desempilharCandidato(fila, &numFila);
+        if (atual.antena) {
+            ok = acrescentarResultado(&r, atual.antena);
+            continue;
+        }
+        NoEspacial* no = atual.no;
+        if (no->folha) {
+            for (int i = 0; i < no->numAntenas && ok; i++) {
+                VAntena* a = no->antenas[i];
+                if (freq != QUALQUER_FREQUENCIA && (unsigned char)a->frequencia != freq) continue;
+                CandidatoEspacial c = { distanciaAntena(a, linha, coluna), NULL, a };
+                ok = empilharCandidato(&fila, &numFila, &capacidadeFila, c);
+            }
+        } else {
+            for (int q = 0; q < 4 && ok; q++) {
+                NoEspacial* filho = no->filhos[q];
+                if (!filho || filho->total == 0 || !temFrequencia(filho, freq)) continue;
+                CandidatoEspacial c = { distanciaNo(filho, linha, coluna), filho, NULL };
+                ok = empilharCandidato(&fila, &numFila, &capacidadeFila, c);
+            }
+        }
+    }
+    free(fila);
+    return entregarResultado(&r, ok, num);
+}
+
+/**
+ * @brief Devolve as k antenas mais próximas (distância euclidiana) de uma posição, da mais próxima para a mais afastada.
+ * @details Pesquisa "best-first": a fila de prioridade tem nós (pela distância ao seu quadrado) e antenas;
+ *          quando sai uma antena, nenhuma antena por visitar está mais perto. Empates são desfeitos pelo id.
+ *          Uma antena na própria posição conta (distância 0); para os vizinhos de uma antena, pedir k+1.
+ * @param g Ponteiro para o grafo.
+ * @param linha Linha do centro.
+ * @param coluna Coluna do centro.
+ * @param k Número de antenas pedidas.
+ * @param freq Frequência (valor unsigned char) ou QUALQUER_FREQUENCIA.
+ * @param num Ponteiro onde guardar o número de antenas devolvidas (menos de k se não houver mais).
+ * @return Vetor de antenas (libertar com free), ou NULL se não houver nenhuma ou em caso de erro.
+ */
+VAntena** antenasMaisProximas(Grafo* g, int linha, int coluna, int k, int freq, int* num) {
+    METRICA_INICIO(inicio);
+    VAntena** r = antenasMaisProximasInterno(g, linha, coluna, k, freq, num);
+    METRICA_FIM(g, METRICA_ANTENAS_PROXIMAS, inicio);
+    return r;
+}
+
+#pragma endregion
+
+#endif
@@ -0,0 +1,86 @@
+#ifndef ESPACIAL_H
+#define ESPACIAL_H
+
+#include <stdbool.h>
+#include "Dados.h"
+
+/**
+ * @file Espacial.h
+ * @brief Índice espacial (quadtree) para consultas por retângulo, raio e vizinhos mais próximos.
+ * @author João Novais
+ * @date 2025-05-18
+ */
+
+// Valor de frequência que aceita antenas de qualquer frequência nas consultas
+#define QUALQUER_FREQUENCIA (-1)
+
+/**
+ * @brief Constrói o índice espacial com todas as antenas do grafo (se ainda não existir).
+ * @details Depois de construído, o índice é mantido por registarVertice/retirarVertice.
+ * @param g Ponteiro para o grafo.
+ * @return true se o índice está pronto, false em caso de erro de memória.
+ */
+bool construirIndiceEspacial(Grafo* g);
+
+/**
+ * @brief Liberta o índice espacial (volta a ser construído na próxima consulta).
+ * @param g Ponteiro para o grafo.
+ * @return true após libertar.
+ */
+bool libertarIndiceEspacial(Grafo* g);
+
+/**
+ * @brief Acrescenta uma antena ao índice espacial, se este já estiver construído.
+ * @param g Ponteiro para o grafo.
+ * @param ant Ponteiro para a antena.
+ * @return true se acrescentou (ou não há índice), false se faltou memória (o índice é então descartado).
+ */
+bool registarEspacial(Grafo* g, VAntena* ant);
+
+/**
+ * @brief Retira uma antena do índice espacial, se este já estiver construído.
+ * @param g Ponteiro para o grafo.
+ * @param ant Ponteiro para a antena.
+ * @return true se retirou (ou não há índice), false se a antena não estava no índice.
+ */
+bool retirarEspacial(Grafo* g, VAntena* ant);
+
+/**
+ * @brief Devolve as antenas dentro de um retângulo (limites incluídos).
+ * @param g Ponteiro para o grafo.
+ * @param linhaMin Primeira linha.
+ * @param colunaMin Primeira coluna.
+ * @param linhaMax Última linha.
+ * @param colunaMax Última coluna.
+ * @param freq Frequência (valor unsigned char) ou QUALQUER_FREQUENCIA.
+ * @param num Ponteiro onde guardar o número de antenas encontradas.
+ * @return Vetor de antenas (libertar com free), ou NULL se não houver nenhuma ou em caso de erro.
+ */
+VAntena** antenasRetangulo(Grafo* g, int linhaMin, int colunaMin, int linhaMax, int colunaMax, int freq, int* num);
+
+/**
+ * @brief Devolve as antenas a distância (euclidiana) não superior a raio de uma posição.
+ * @param g Ponteiro para o grafo.
+ * @param linha Linha do centro.
+ * @param coluna Coluna do centro.
+ * @param raio Raio.
+ * @param freq Frequência (valor unsigned char) ou QUALQUER_FREQUENCIA.
+ * @param num Ponteiro onde guardar o número de antenas encontradas.
+ * @return Vetor de antenas (libertar com free), ou NULL se não houver nenhuma ou em caso de erro.
+ */
+VAntena** antenasRaio(Grafo* g, int linha, int coluna, double raio, int freq, int* num);
+
+/**
+ * @brief Devolve as k antenas mais próximas (distância euclidiana) de uma posição, da mais próxima para a mais afastada.
+ * @details Uma antena na própria posição conta (distância 0); para os vizinhos de uma antena, pedir k+1.
+ * @param g Ponteiro para o grafo.
+ * @param linha Linha do centro.
+ * @param coluna Coluna do centro.
+ * @param k Número de antenas pedidas.
+ * @param freq Frequência (valor unsigned char) ou QUALQUER_FREQUENCIA.
+ * @param num Ponteiro onde guardar o número de antenas devolvidas (menos de k se não houver mais).
+ * @return Vetor de antenas (libertar com free), ou NULL se não houver nenhuma ou em caso de erro.
+ */
+VAntena** antenasMaisProximas(Grafo* g, int linha, int coluna, int k, int freq, int* num);
+
+#endif
@@ -4,11 +4,16 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
+#include <string.h>
 #include <math.h>
 #include "Antena.h"
 #include "Grafo.h"
 #include "Nefasto.h"
 #include "Ficheiros.h"
+#include "Memoria.h"
+#include "Indice.h"
+#include "Metricas.h"
 /**
  * @file Ficheiros.c
  * @brief Funções para ler e escrever o grafo em ficheiros.
@@ -19,99 +24,1092 @@
 
 #pragma region Ficheiros
 
+// Tamanho de cada bloco lido do ficheiro de texto
+#define BLOCO_LEITURA (1 << 20)
+// Oito caracteres '.' num inteiro de 64 bits, para saltar células vazias 8 a 8
+#define OITO_PONTOS 0x2E2E2E2E2E2E2E2EULL
+
+/**
+ * @brief Acrescenta um registo de antena a um vetor dinâmico.
+ * @param registos Ponteiro para o vetor (realocado quando enche).
+ * @param num Ponteiro para o número de registos.
+ * @param capacidade Ponteiro para a capacidade do vetor.
+ * @param freq Frequência.
+ * @param linha Linha.
+ * @param coluna Coluna.
+ * @return true se acrescentou, false em caso de erro de memória.
+ */
+static bool acrescentarRegisto(RegistoAntena** registos, int* num, int* capacidade, char freq, int linha, int coluna) {
+    if (*num == *capacidade) {
+        int nova = *capacidade ? *capacidade * 2 : 1024;
+        RegistoAntena* novo = realloc(*registos, (size_t)nova * sizeof(RegistoAntena));
+        if (!novo) return false;
+        *registos = novo;
+        *capacidade = nova;
+    }
+    (*registos)[*num].frequencia = freq;
+    (*registos)[*num].linha = linha;
+    (*registos)[*num].coluna = coluna;
+    (*num)++;
+    return true;
+}
+
+/**
+ * @brief Corpo de lerMatrizAntenas, sem a medição de tempo (ver lerMatrizAntenas).
+ */
+static bool lerMatrizAntenasInterno(Grafo* g, const char* filename, int* linhas, int* colunas) {
+    if (!g) return false;
+    FILE* file = fopen(filename, "rb");
+    if (!file) return false;
+
+    char* bloco = malloc(BLOCO_LEITURA);
+    if (!bloco) {
+        fclose(file);
+        return false;
+    }
+
+    RegistoAntena* registos = NULL;
+    int numRegistos = 0, capacidade = 0;
+    int max_linha = 0, max_col = 0;
+    int col_atual = 0;
+    bool linhaAberta = false; // Há caracteres na linha atual ainda sem '\n'
+    bool ok = true;
+    size_t lidos;
+
+    while (ok && (lidos = fread(bloco, 1, BLOCO_LEITURA, file)) > 0) {
+        size_t i = 0;
+        while (i < lidos) {
+            char c = bloco[i];
+            if (c == '.') {
+                // Salta células vazias 8 a 8 enquanto o bloco tiver 8 pontos seguidos
+                uint64_t oito;
+                while (i + 8 <= lidos) {
+                    memcpy(&oito, bloco + i, 8);
+                    if (oito != OITO_PONTOS) break;
+                    i += 8;
+                    col_atual += 8;
+                }
+                while (i < lidos && bloco[i] == '.') {
+                    i++;
+                    col_atual++;
+                }
+                linhaAberta = true;
+                continue;
+            }
+            i++;
+            if (c == '\n') {
+                if (col_atual > max_col) max_col = col_atual;
+                max_linha++;
+                col_atual = 0;
+                linhaAberta = false;
+                continue;
+            }
+            linhaAberta = true;
+            if (c == '\r') continue;
+            if (c != '#') {
+                ok = acrescentarRegisto(&registos, &numRegistos, &capacidade, c, max_linha, col_atual);
+                if (!ok) break;
+            }
+            col_atual++;
+        }
+    }
+    // Última linha sem '\n'
+    if (linhaAberta) {
+        if (col_atual > max_col) max_col = col_atual;
+        max_linha++;
+    }
+    free(bloco);
+    METRICA_CONTAR(g, bytesLidos, ftell(file));
+    fclose(file);
+
+    if (ok) {
+        // Com as dimensões e o número de antenas conhecidos o índice de posições pode usar a grelha densa
+        ok = prepararDimensoesGrafo(g, max_linha, max_col, numRegistos) &&
+             inserirAntenasLote(g, registos, numRegistos) >= 0;
+        if (linhas) *linhas = max_linha;
+        if (colunas) *colunas = max_col;
+    }
+    free(registos);
+    return ok;
+}
+
 /**
  * @brief Lê uma matriz de antenas de um ficheiro de texto e insere no grafo.
+ * @details O ficheiro é lido em blocos grandes, sem limite de largura das linhas ('\r' é ignorado).
+ *          Sequências de '.' são saltadas 8 células de cada vez. As antenas são primeiro acumuladas e só
+ *          inseridas no fim, num só lote (inserirAntenasLote), depois de definidas as dimensões, para o índice
+ *          de posições já ser a grelha densa.
  * @param g Ponteiro para o grafo.
  * @param filename Nome do ficheiro de texto.
+ * @param linhas Ponteiro para guardar o número de linhas.
+ * @param colunas Ponteiro para guardar o número de colunas.
  * @return true se leu e inseriu com sucesso, false caso contrário.
  */
 // Leitura de matriz de antenas (como no enunciado)
 bool lerMatrizAntenas(Grafo* g, const char* filename, int* linhas, int* colunas) {
+    METRICA_INICIO(inicio);
+    bool r = lerMatrizAntenasInterno(g, filename, linhas, colunas);
+    METRICA_FIM(g, METRICA_LER_MATRIZ, inicio);
+    return r;
+}
+// Cabeçalho opcional do formato esparso com as dimensões do mapa
+#define ESPARSO_DIMENSOES "dim"
+
+/**
+ * @brief Lê um inteiro não negativo de texto, avançando o cursor.
+ * @param p Ponteiro para o cursor.
+ * @param valor Ponteiro onde guardar o valor.
+ * @return true se leu pelo menos um dígito, false caso contrário.
+ */
+static bool lerInteiroTexto(const char** p, int* valor) {
+    const char* c = *p;
+    long long v = 0;
+    if (*c < '0' || *c > '9') return false;
+    while (*c >= '0' && *c <= '9') {
+        v = v * 10 + (*c - '0');
+        if (v > 2147483647LL) return false;
+        c++;
+    }
+    *valor = (int)v;
+    *p = c;
+    return true;
+}
+
+/**
+ * @brief Corpo de lerMapaEsparso, sem a medição de tempo (ver lerMapaEsparso).
+ */
+static bool lerMapaEsparsoInterno(Grafo* g, const char* filename, int* linhas, int* colunas) {
+    if (!g) return false;
     FILE* file = fopen(filename, "r");
     if (!file) return false;
 
-    char linha[256];
+    RegistoAntena* registos = NULL;
+    int numRegistos = 0, capacidade = 0;
     int max_linha = 0, max_col = 0;
+    bool comDimensoes = false;
+    bool ok = true;
+    char linha[128];
 
-    while (fgets(linha, sizeof(linha), file)) {
-        int col_atual;
-        for (col_atual = 0; linha[col_atual] != '\0' && linha[col_atual] != '\n'; col_atual++) {
-            char c = linha[col_atual];
-            if (c != '.' && c != '#') {
-                inserirAntena(g, c, max_linha, col_atual);
-            }
+    while (ok && fgets(linha, sizeof(linha), file)) {
+        const char* p = linha;
+        if (*p == '\n' || *p == '\r' || *p == '\0') continue;
+        int l, c;
+        if (!comDimensoes && numRegistos == 0 && strncmp(p, ESPARSO_DIMENSOES ",", 4) == 0) {
+            p += 4;
+            ok = lerInteiroTexto(&p, &max_linha) && *p++ == ',' && lerInteiroTexto(&p, &max_col);
+            comDimensoes = true;
+            continue;
+        }
+        char freq = *p++;
+        ok = *p++ == ',' && lerInteiroTexto(&p, &l) && *p++ == ',' && lerInteiroTexto(&p, &c);
+        if (!ok || freq == '#' || freq == '.') continue;
+        ok = acrescentarRegisto(&registos, &numRegistos, &capacidade, freq, l, c);
+        if (!comDimensoes) {
+            if (l + 1 > max_linha) max_linha = l + 1;
+            if (c + 1 > max_col) max_col = c + 1;
         }
-        if (col_atual > max_col) max_col = col_atual;
-        max_linha++;
-    
-       
     }
+    METRICA_CONTAR(g, bytesLidos, ftell(file));
     fclose(file);
-    if (linhas) *linhas = max_linha;
-    if (colunas) *colunas = max_col;
-    return true;
+
+    if (ok) {
+        ok = prepararDimensoesGrafo(g, max_linha, max_col, numRegistos) &&
+             inserirAntenasLote(g, registos, numRegistos) >= 0;
+        if (linhas) *linhas = max_linha;
+        if (colunas) *colunas = max_col;
+    }
+    free(registos);
+    return ok;
 }
+
 /**
- * @brief Guarda o grafo num ficheiro binário.
- * @param filename Nome do ficheiro binário.
+ * @brief Lê um mapa de antenas em formato esparso (uma antena por linha) e insere no grafo.
+ * @details Cada linha tem "freq,linha,coluna"; a primeira pode ser "dim,linhas,colunas" com as dimensões do
+ *          mapa (sem ela, as dimensões são as menores que contêm todas as antenas). Linhas vazias são ignoradas,
+ *          tal como entradas com frequência '#' (efeitos escritos por escreverMapaEsparso). O custo depende só do
+ *          número de antenas, não da área do mapa.
  * @param g Ponteiro para o grafo.
- * @return true se guardou, false caso contrário.
+ * @param filename Nome do ficheiro de texto.
+ * @param linhas Ponteiro para guardar o número de linhas.
+ * @param colunas Ponteiro para guardar o número de colunas.
+ * @return true se leu e inseriu com sucesso, false se o ficheiro não existir ou tiver uma linha inválida.
  */
+bool lerMapaEsparso(Grafo* g, const char* filename, int* linhas, int* colunas) {
+    METRICA_INICIO(inicio);
+    bool r = lerMapaEsparsoInterno(g, filename, linhas, colunas);
+    METRICA_FIM(g, METRICA_LER_ESPARSO, inicio);
+    return r;
+}
 
-bool guardarBinario(const char* filename, Grafo* g) {
+/**
+ * @brief Corpo de escreverMapaEsparso, sem a medição de tempo (ver escreverMapaEsparso).
+ */
+static bool escreverMapaEsparsoInterno(const char* filename, Grafo* g, EfeitoNefasto* efeitos, int linhas, int colunas) {
+    if (!g) return false;
+    FILE* f = fopen(filename, "w");
+    if (!f) return false;
+
+    fprintf(f, ESPARSO_DIMENSOES ",%d,%d\n", linhas, colunas);
+    for (VAntena* ant = g->listaAntenas; ant != NULL; ant = ant->proximo) {
+        fprintf(f, "%c,%d,%d\n", ant->frequencia, ant->linha, ant->coluna);
+    }
+    for (EfeitoNefasto* e = efeitos; e != NULL; e = e->proximo) {
+        if (e->linha < 0 || e->linha >= linhas || e->coluna < 0 || e->coluna >= colunas) continue;
+        if (consultarIndice(&g->indice, e->linha, e->coluna)) continue;
+        fprintf(f, "#,%d,%d\n", e->linha, e->coluna);
+    }
+    bool ok = !ferror(f);
+    METRICA_CONTAR(g, bytesEscritos, ftell(f));
+    if (fclose(f) != 0) ok = false;
+    return ok;
+}
+
+/**
+ * @brief Escreve o mapa em formato esparso: dimensões, antenas e (opcionalmente) efeitos nefastos.
+ * @details Escreve "dim,linhas,colunas", uma linha "freq,linha,coluna" por antena e uma linha "#,linha,coluna"
+ *          por efeito dentro do mapa que não esteja numa célula com antena (como em escreverMapaComEfeitos).
+ * @param filename Nome do ficheiro a escrever.
+ * @param g Ponteiro para o grafo.
+ * @param efeitos Lista de efeitos nefastos (NULL para escrever só as antenas).
+ * @param linhas Número de linhas do mapa.
+ * @param colunas Número de colunas do mapa.
+ * @return true se escreveu, false caso contrário.
+ */
+bool escreverMapaEsparso(const char* filename, Grafo* g, EfeitoNefasto* efeitos, int linhas, int colunas) {
+    METRICA_INICIO(inicio);
+    bool r = escreverMapaEsparsoInterno(filename, g, efeitos, linhas, colunas);
+    METRICA_FIM(g, METRICA_ESCREVER_ESPARSO, inicio);
+    return r;
+}
+
+// Formato binário v2: cabeçalho fixo seguido de registos compactos e, opcionalmente, das arestas
+#define BINARIO_MAGICO "EDAG"
+#define BINARIO_VERSAO 2
+#define BINARIO_CABECALHO 32
+#define BINARIO_REGISTO 9
+#define BINARIO_ARESTA 8
+// A soma de verificação cobre o cabeçalho até ao próprio campo da soma (bytes 0-27) e depois os dados
+#define BINARIO_CABECALHO_SOMADO 28
+// Bits do campo de opções do cabeçalho
+#define BINARIO_COM_ARESTAS 1u
+#define BINARIO_FREQUENCIAS_LIGADAS 2u
+// Tamanho do buffer de escrita/leitura em blocos
+#define BLOCO_BINARIO (1 << 16)
+
+/**
+ * @brief Buffer de escrita em blocos, com soma de verificação do que passa por ele.
+ */
+typedef struct EscritaBlocos {
+    FILE* f;
+    unsigned char dados[BLOCO_BINARIO];
+    size_t usados;
+    uint32_t soma;
+    long long escritos;
+    bool ok;
+} EscritaBlocos;
+
+/**
+ * @brief Atualiza uma soma de verificação FNV-1a de 32 bits.
+ * @param soma Soma acumulada (começar em 2166136261).
+ * @param dados Bytes a acrescentar.
+ * @param tamanho Número de bytes.
+ * @return Soma atualizada.
+ */
+static uint32_t somaVerificacao(uint32_t soma, const unsigned char* dados, size_t tamanho) {
+    for (size_t i = 0; i < tamanho; i++) {
+        soma ^= dados[i];
+        soma *= 16777619u;
+    }
+    return soma;
+}
+
+/**
+ * @brief Escreve um inteiro de 32 bits em little-endian.
+ * @param p Destino (4 bytes).
+ * @param v Valor.
+ */
+static void escreverU32(unsigned char* p, uint32_t v) {
+    p[0] = (unsigned char)v;
+    p[1] = (unsigned char)(v >> 8);
+    p[2] = (unsigned char)(v >> 16);
+    p[3] = (unsigned char)(v >> 24);
+}
+
+/**
+ * @brief Lê um inteiro de 32 bits em little-endian.
+ * @param p Origem (4 bytes).
+ * @return Valor lido.
+ */
+static uint32_t lerU32(const unsigned char* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * @brief Escreve no ficheiro o que está no buffer.
+ * @param e Ponteiro para o buffer.
+ */
+static void despejarBlocos(EscritaBlocos* e) {
+    if (e->usados && fwrite(e->dados, 1, e->usados, e->f) != e->usados) e->ok = false;
+    e->escritos += (long long)e->usados;
+    e->usados = 0;
+}
+
+/**
+ * @brief Acrescenta bytes ao buffer (e à soma de verificação), despejando-o quando enche.
+ * @param e Ponteiro para o buffer.
+ * @param dados Bytes a escrever.
+ * @param tamanho Número de bytes (no máximo BLOCO_BINARIO).
+ */
+static void escreverBlocos(EscritaBlocos* e, const void* dados, size_t tamanho) {
+    if (e->usados + tamanho > BLOCO_BINARIO) despejarBlocos(e);
+    memcpy(e->dados + e->usados, dados, tamanho);
+    e->soma = somaVerificacao(e->soma, e->dados + e->usados, tamanho);
+    e->usados += tamanho;
+}
+
+/**
+ * @brief Corpo de guardarBinario, sem a medição de tempo (ver guardarBinario).
+ */
+static bool guardarBinarioInterno(const char* filename, Grafo* g) {
+    if (!g) return false;
     FILE* f = fopen(filename, "wb");
     if (!f) return false;
 
+    EscritaBlocos* e = malloc(sizeof(EscritaBlocos));
+    if (!e) {
+        fclose(f);
+        return false;
+    }
+    e->f = f;
+    e->usados = 0;
+    e->soma = 0;
+    e->escritos = 0;
+    e->ok = true;
+
     // Guardar número de antenas
-    fwrite(&g->numAntenas, sizeof(int), 1, f);
-    VAntena* atual = g->listaAntenas;
+    escreverBlocos(e, &g->numAntenas, sizeof(int));
     // Guardar dados de cada antena
-    for (atual = g->listaAntenas; atual != NULL; atual = atual->proximo) {
-        fwrite(&atual->frequencia, sizeof(char), 1, f);
-        fwrite(&atual->linha, sizeof(int), 1, f);
-        fwrite(&atual->coluna, sizeof(int), 1, f);
+    for (VAntena* atual = g->listaAntenas; atual != NULL; atual = atual->proximo) {
+        unsigned char registo[sizeof(char) + 2 * sizeof(int)];
+        registo[0] = (unsigned char)atual->frequencia;
+        memcpy(registo + 1, &atual->linha, sizeof(int));
+        memcpy(registo + 1 + sizeof(int), &atual->coluna, sizeof(int));
+        escreverBlocos(e, registo, sizeof(registo));
     }
+    despejarBlocos(e);
 
-    fclose(f);
+    bool ok = e->ok;
+    METRICA_CONTAR(g, bytesEscritos, e->escritos);
+    free(e);
+    if (fclose(f) != 0) ok = false;
+    return ok;
+}
+
+/**
+ * @brief Guarda o grafo num ficheiro binário (formato antigo, sem cabeçalho).
+ * @details Os registos são acumulados num buffer e escritos em blocos, em vez de três fwrite por antena.
+ * @param filename Nome do ficheiro binário.
+ * @param g Ponteiro para o grafo.
+ * @return true se guardou, false caso contrário.
+ */
+
+bool guardarBinario(const char* filename, Grafo* g) {
+    METRICA_INICIO(inicio);
+    bool r = guardarBinarioInterno(filename, g);
+    METRICA_FIM(g, METRICA_GUARDAR_BINARIO, inicio);
+    return r;
+}
+
+/**
+ * @brief Indica se todas as antenas do grafo estão marcadas como ligadas por frequência.
+ * @param g Ponteiro para o grafo.
+ * @return true se as ligações implícitas cobrem todas as antenas, false caso contrário.
+ */
+static bool todasLigadasFrequencia(const Grafo* g) {
+    if (!g->frequenciasLigadas) return false;
+    for (int i = 0; i < g->numAntenas; i++) {
+        if (!g->vertices[i]->ligadaFrequencia) return false;
+    }
     return true;
 }
 
+/**
+ * @brief Corpo de guardarBinarioV2, sem a medição de tempo (ver guardarBinarioV2).
+ */
+static bool guardarBinarioV2Interno(const char* filename, Grafo* g, bool incluirArestas) {
+    if (!g) return false;
+
+    // Com ligações implícitas parciais (antenas inseridas depois da ligação), a opção do cabeçalho ligaria
+    // todas ao ler; nesse caso as arestas são guardadas já expandidas pelo iterador de vizinhos
+    bool todasLigadas = todasLigadasFrequencia(g);
+    bool expandir = g->frequenciasLigadas && !todasLigadas;
+    uint32_t numArestas = 0;
+    if (incluirArestas) {
+        for (int i = 0; i < g->numAntenas; i++) {
+            if (expandir) {
+                IteradorVizinhos it;
+                iniciarVizinhos(&it, g->vertices[i]);
+                while (proximoVizinho(&it)) numArestas++;
+            } else {
+                for (Adjacente* adj = g->vertices[i]->listaAdj; adj != NULL; adj = adj->proximo) numArestas++;
+            }
+        }
+    }
+
+    FILE* f = fopen(filename, "wb");
+    if (!f) return false;
+    EscritaBlocos* e = malloc(sizeof(EscritaBlocos));
+    if (!e) {
+        fclose(f);
+        return false;
+    }
+    e->f = f;
+    e->usados = 0;
+    e->escritos = BINARIO_CABECALHO;
+    e->ok = true;
+
+    // Cabeçalho provisório: a soma de verificação só é conhecida no fim
+    unsigned char cabecalho[BINARIO_CABECALHO];
+    uint32_t opcoes = 0;
+    if (incluirArestas) opcoes |= BINARIO_COM_ARESTAS;
+    if (incluirArestas && todasLigadas) opcoes |= BINARIO_FREQUENCIAS_LIGADAS;
+    memcpy(cabecalho, BINARIO_MAGICO, 4);
+    escreverU32(cabecalho + 4, BINARIO_VERSAO);
+    escreverU32(cabecalho + 8, (uint32_t)g->linhas);
+    escreverU32(cabecalho + 12, (uint32_t)g->colunas);
+    escreverU32(cabecalho + 16, (uint32_t)g->numAntenas);
+    escreverU32(cabecalho + 20, numArestas);
+    escreverU32(cabecalho + 24, opcoes);
+    escreverU32(cabecalho + 28, 0);
+    e->soma = somaVerificacao(2166136261u, cabecalho, BINARIO_CABECALHO_SOMADO);
+    if (fwrite(cabecalho, 1, BINARIO_CABECALHO, f) != BINARIO_CABECALHO) e->ok = false;
+
+    for (int i = 0; i < g->numAntenas; i++) {
+        VAntena* atual = g->vertices[i];
+        unsigned char registo[BINARIO_REGISTO];
+        registo[0] = (unsigned char)atual->frequencia;
+        escreverU32(registo + 1, (uint32_t)atual->linha);
+        escreverU32(registo + 5, (uint32_t)atual->coluna);
+        escreverBlocos(e, registo, BINARIO_REGISTO);
+    }
+    if (incluirArestas) {
+        for (int i = 0; i < g->numAntenas; i++) {
+            IteradorVizinhos it;
+            iniciarVizinhos(&it, g->vertices[i]);
+            Adjacente* adj = g->vertices[i]->listaAdj;
+            for (;;) {
+                VAntena* destino = expandir ? proximoVizinho(&it) : (adj ? adj->destino : NULL);
+                if (!destino) break;
+                if (!expandir) adj = adj->proximo;
+                unsigned char aresta[BINARIO_ARESTA];
+                escreverU32(aresta, (uint32_t)i);
+                escreverU32(aresta + 4, (uint32_t)destino->id);
+                escreverBlocos(e, aresta, BINARIO_ARESTA);
+            }
+        }
+    }
+    despejarBlocos(e);
+
+    // Completa o cabeçalho com a soma de verificação
+    escreverU32(cabecalho + 28, e->soma);
+    if (fseek(f, 28, SEEK_SET) != 0 || fwrite(cabecalho + 28, 1, 4, f) != 4) e->ok = false;
+
+    bool ok = e->ok;
+    METRICA_CONTAR(g, bytesEscritos, e->escritos);
+    free(e);
+    if (fclose(f) != 0) ok = false;
+    return ok;
+}
+
+/**
+ * @brief Guarda o grafo num ficheiro binário no formato v2.
+ * @details Cabeçalho de 32 bytes (little-endian): "EDAG", versão, linhas, colunas, número de antenas,
+ *          número de arestas, opções e soma de verificação FNV-1a (dos bytes 0-27 do cabeçalho e dos dados).
+ *          Seguem-se registos de 9 bytes (frequência, linha, coluna) pela ordem dos ids e, se pedido, as arestas
+ *          explícitas como pares (id origem, id destino). Tudo é escrito em blocos.
+ * @param filename Nome do ficheiro binário.
+ * @param g Ponteiro para o grafo.
+ * @param incluirArestas true para guardar também as adjacências.
+ * @return true se guardou, false caso contrário.
+ */
+bool guardarBinarioV2(const char* filename, Grafo* g, bool incluirArestas) {
+    METRICA_INICIO(inicio);
+    bool r = guardarBinarioV2Interno(filename, g, incluirArestas);
+    METRICA_FIM(g, METRICA_GUARDAR_BINARIO_V2, inicio);
+    return r;
+}
+
+// Formato compactado: antenas agrupadas por frequência, ordenadas por (linha, coluna) e guardadas como diferenças em varint
+#define COMPACTO_MAGICO "EDAC"
+#define COMPACTO_VERSAO 1
+#define COMPACTO_CABECALHO 24
+// Número máximo de bytes de um varint de 32 bits
+#define VARINT_MAX 5
 
 /**
- * @brief Lê um grafo de um ficheiro binário.
+ * @brief Converte um inteiro com sinal para sem sinal, com os valores pequenos (positivos ou negativos) perto de 0.
+ * @param v Valor.
+ * @return 0, -1, 1, -2, 2, ... passam a 0, 1, 2, 3, 4, ...
+ */
+static uint32_t zigzag(int v) {
+    return ((uint32_t)v << 1) ^ (v < 0 ? 0xFFFFFFFFu : 0u);
+}
+
+/**
+ * @brief Inverso de zigzag.
+ * @param v Valor codificado.
+ * @return Inteiro original.
+ */
+static int desfazerZigzag(uint32_t v) {
+    return (int)((v >> 1) ^ (0u - (v & 1u)));
+}
+
+/**
+ * @brief Escreve um inteiro de 32 bits em varint (7 bits por byte, o bit mais alto indica que há mais bytes).
+ * @param p Destino (no máximo VARINT_MAX bytes).
+ * @param v Valor.
+ * @return Número de bytes escritos.
+ */
+static size_t escreverVarint(unsigned char* p, uint32_t v) {
+    size_t n = 0;
+    while (v >= 0x80u) {
+        p[n++] = (unsigned char)(v | 0x80u);
+        v >>= 7;
+    }
+    p[n++] = (unsigned char)v;
+    return n;
+}
+
+/**
+ * @brief Corpo de guardarBinarioCompactado, sem a medição de tempo (ver guardarBinarioCompactado).
+ */
+static bool guardarBinarioCompactadoInterno(const char* filename, Grafo* g) {
+    if (!g) return false;
+    // As cópias ordenadas dos baldes são preparadas antes de criar o ficheiro
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+        if (g->baldes[f].numAntenas > 0 && !ordenarBaldePorLinha(&g->baldes[f])) return false;
+    }
+
+    FILE* f = fopen(filename, "wb");
+    if (!f) return false;
+    EscritaBlocos* e = malloc(sizeof(EscritaBlocos));
+    if (!e) {
+        fclose(f);
+        return false;
+    }
+    e->f = f;
+    e->usados = 0;
+    e->soma = 2166136261u;
+    e->escritos = COMPACTO_CABECALHO;
+    e->ok = true;
+
+    // Cabeçalho provisório: a soma de verificação só é conhecida no fim
+    unsigned char cabecalho[COMPACTO_CABECALHO];
+    memcpy(cabecalho, COMPACTO_MAGICO, 4);
+    escreverU32(cabecalho + 4, COMPACTO_VERSAO);
+    escreverU32(cabecalho + 8, (uint32_t)g->linhas);
+    escreverU32(cabecalho + 12, (uint32_t)g->colunas);
+    escreverU32(cabecalho + 16, (uint32_t)g->numAntenas);
+    escreverU32(cabecalho + 20, 0);
+    if (fwrite(cabecalho, 1, COMPACTO_CABECALHO, f) != COMPACTO_CABECALHO) e->ok = false;
+
+    for (int freq = 0; freq < NUM_FREQUENCIAS; freq++) {
+        BaldeFrequencia* b = &g->baldes[freq];
+        if (b->numAntenas == 0) continue;
+        // Grupo: frequência e número de antenas
+        unsigned char registo[1 + 2 * VARINT_MAX];
+        registo[0] = (unsigned char)freq;
+        escreverBlocos(e, registo, 1 + escreverVarint(registo + 1, (uint32_t)b->numAntenas));
+
+        // A primeira antena vai completa; as seguintes só com a diferença para a anterior
+        VAntena* anterior = NULL;
+        for (int i = 0; i < b->numAntenas; i++) {
+            VAntena* atual = b->porLinha[i];
+            size_t n;
+            if (!anterior) {
+                n = escreverVarint(registo, zigzag(atual->linha));
+                n += escreverVarint(registo + n, zigzag(atual->coluna));
+            } else {
+                uint32_t dLinha = (uint32_t)atual->linha - (uint32_t)anterior->linha;
+                n = escreverVarint(registo, dLinha);
+                // Na mesma linha a coluna é sempre maior (posições distintas): guarda-se a distância menos 1
+                if (dLinha == 0) n += escreverVarint(registo + n, (uint32_t)atual->coluna - (uint32_t)anterior->coluna - 1u);
+                else n += escreverVarint(registo + n, zigzag(atual->coluna));
+            }
+            escreverBlocos(e, registo, n);
+            anterior = atual;
+        }
+    }
+    despejarBlocos(e);
+
+    // Completa o cabeçalho com a soma de verificação
+    escreverU32(cabecalho + 20, e->soma);
+    if (fseek(f, 20, SEEK_SET) != 0 || fwrite(cabecalho + 20, 1, 4, f) != 4) e->ok = false;
+
+    bool ok = e->ok;
+    METRICA_CONTAR(g, bytesEscritos, e->escritos);
+    free(e);
+    if (fclose(f) != 0) ok = false;
+    return ok;
+}
+
+/**
+ * @brief Guarda o grafo num ficheiro binário compactado.
+ * @details Cabeçalho de 24 bytes (little-endian): "EDAC", versão, linhas, colunas, número de antenas e soma de
+ *          verificação FNV-1a dos dados. Seguem-se as frequências com antenas, por ordem crescente: o byte da
+ *          frequência, o número de antenas em varint e as antenas ordenadas por (linha, coluna) (a cópia
+ *          ordenada do balde, BaldeFrequencia::porLinha). A primeira antena de cada grupo guarda linha e coluna
+ *          em zigzag; as seguintes guardam a diferença de linha e, na mesma linha, a distância à coluna
+ *          anterior menos 1 (senão a coluna em zigzag). Em mapas densos cada antena ocupa 2 a 3 bytes, em vez
+ *          dos 9 do formato v2. As arestas não são guardadas.
  * @param filename Nome do ficheiro binário.
  * @param g Ponteiro para o grafo.
+ * @return true se guardou, false caso contrário.
+ */
+bool guardarBinarioCompactado(const char* filename, Grafo* g) {
+    METRICA_INICIO(inicio);
+    bool r = guardarBinarioCompactadoInterno(filename, g);
+    METRICA_FIM(g, METRICA_GUARDAR_COMPACTADO, inicio);
+    return r;
+}
+
+/**
+ * @brief Lê o próximo byte do ficheiro compactado, carregando outro bloco quando o atual acaba.
+ * @param d Ponteiro para o descodificador.
+ * @return Byte lido, ou -1 no fim do ficheiro.
+ */
+static int lerByteDescodificador(DescodificadorBinario* d) {
+    if (d->posicao == d->usados) {
+        d->usados = fread(d->bloco, 1, BLOCO_BINARIO, d->f);
+        d->posicao = 0;
+        if (d->usados == 0) return -1;
+        d->soma = somaVerificacao(d->soma, d->bloco, d->usados);
+    }
+    return d->bloco[d->posicao++];
+}
+
+/**
+ * @brief Lê um varint de 32 bits do ficheiro compactado.
+ * @param d Ponteiro para o descodificador (erro passa a true se o ficheiro acabar ou o varint for inválido).
+ * @param v Ponteiro para guardar o valor.
  * @return true se leu, false caso contrário.
  */
-// Ler do ficheiro binário
+static bool lerVarintDescodificador(DescodificadorBinario* d, uint32_t* v) {
+    uint32_t valor = 0;
+    for (int i = 0; i < VARINT_MAX; i++) {
+        int c = lerByteDescodificador(d);
+        // O quinto byte só pode ter os 4 bits que faltam
+        if (c < 0 || (i == VARINT_MAX - 1 && c > 0x0F)) break;
+        valor |= (uint32_t)(c & 0x7F) << (7 * i);
+        if (!(c & 0x80)) {
+            *v = valor;
+            return true;
+        }
+    }
+    d->erro = true;
+    return false;
+}
 
-bool lerBinario(const char* filename, Grafo* g) {
+/**
+ * @brief Prepara o descodificador sobre um ficheiro já aberto, lendo o cabeçalho a partir da posição atual.
+ * @param d Ponteiro para o descodificador.
+ * @param f Ficheiro (passa a pertencer ao descodificador só se a função tiver sucesso).
+ * @return true se o cabeçalho é de um ficheiro compactado válido, false caso contrário.
+ */
+static bool iniciarDescodificador(DescodificadorBinario* d, FILE* f) {
+    unsigned char cabecalho[COMPACTO_CABECALHO];
+    if (fread(cabecalho, 1, COMPACTO_CABECALHO, f) != COMPACTO_CABECALHO) return false;
+    if (memcmp(cabecalho, COMPACTO_MAGICO, 4) != 0 || lerU32(cabecalho + 4) != COMPACTO_VERSAO) return false;
+    if (lerU32(cabecalho + 16) > INT32_MAX) return false;
+    d->bloco = malloc(BLOCO_BINARIO);
+    if (!d->bloco) return false;
+    d->f = f;
+    d->usados = 0;
+    d->posicao = 0;
+    d->soma = 2166136261u;
+    d->linhas = (int)lerU32(cabecalho + 8);
+    d->colunas = (int)lerU32(cabecalho + 12);
+    d->numAntenas = lerU32(cabecalho + 16);
+    d->somaEsperada = lerU32(cabecalho + 20);
+    d->lidas = 0;
+    d->restantesGrupo = 0;
+    d->frequencia = 0;
+    d->linha = 0;
+    d->coluna = 0;
+    d->inicioGrupo = false;
+    d->erro = false;
+    return true;
+}
+
+/**
+ * @brief Abre um ficheiro guardado com guardarBinarioCompactado para o ler registo a registo.
+ * @details Depois de abrir, d->linhas, d->colunas e d->numAntenas têm os valores do cabeçalho. Cada registo
+ *          pode ser passado diretamente a inserirAntena (ou acumulado para inserirAntenasLote); a soma de
+ *          verificação só é conhecida no fim, em fecharDescodificador.
+ * @param d Ponteiro para o descodificador.
+ * @param filename Nome do ficheiro binário.
+ * @return true se abriu, false se o ficheiro não existir ou não for um ficheiro compactado.
+ */
+bool abrirDescodificador(DescodificadorBinario* d, const char* filename) {
+    if (!d) return false;
+    d->f = NULL;
+    d->bloco = NULL;
+    FILE* f = fopen(filename, "rb");
+    if (!f) return false;
+    if (!iniciarDescodificador(d, f)) {
+        fclose(f);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Descodifica o próximo registo do ficheiro compactado.
+ * @param d Ponteiro para o descodificador.
+ * @param r Ponteiro para guardar o registo.
+ * @return true se leu um registo, false no fim dos registos ou se o ficheiro estiver corrompido (d->erro).
+ */
+bool lerRegistoDescodificador(DescodificadorBinario* d, RegistoAntena* r) {
+    if (!d || !r || !d->f || d->erro || d->lidas == d->numAntenas) return false;
+
+    if (d->restantesGrupo == 0) {
+        int freq = lerByteDescodificador(d);
+        uint32_t num;
+        if (freq < 0 || !lerVarintDescodificador(d, &num) || num == 0 || num > d->numAntenas - d->lidas) {
+            d->erro = true;
+            return false;
+        }
+        d->frequencia = (char)freq;
+        d->restantesGrupo = num;
+        d->inicioGrupo = true;
+    }
+
+    uint32_t a, b;
+    if (!lerVarintDescodificador(d, &a) || !lerVarintDescodificador(d, &b)) return false;
+    if (d->inicioGrupo) {
+        d->linha = desfazerZigzag(a);
+        d->coluna = desfazerZigzag(b);
+        d->inicioGrupo = false;
+    } else if (a == 0) {
+        // Mesma linha: a coluna tem de continuar dentro dos inteiros
+        if ((long long)d->coluna + b + 1 > INT32_MAX) {
+            d->erro = true;
+            return false;
+        }
+        d->coluna += (int)b + 1;
+    } else {
+        if ((long long)d->linha + a > INT32_MAX) {
+            d->erro = true;
+            return false;
+        }
+        d->linha += (int)a;
+        d->coluna = desfazerZigzag(b);
+    }
+    d->restantesGrupo--;
+    d->lidas++;
+
+    r->frequencia = d->frequencia;
+    r->linha = d->linha;
+    r->coluna = d->coluna;
+    return true;
+}
+
+/**
+ * @brief Verifica, no fim da leitura, que o ficheiro compactado estava completo e intacto.
+ * @param d Ponteiro para o descodificador.
+ * @return true se todos os registos foram lidos, não sobram bytes e a soma de verificação coincide.
+ */
+static bool verificarDescodificador(DescodificadorBinario* d) {
+    if (d->erro || d->lidas != d->numAntenas) return false;
+    if (lerByteDescodificador(d) >= 0) return false;
+    return d->soma == d->somaEsperada;
+}
+
+/**
+ * @brief Fecha o ficheiro compactado e liberta o descodificador.
+ * @details Os registos lidos antes de uma falha podem ter vindo de um ficheiro corrompido: quem os insere
+ *          à medida que chegam deve tratar o grafo como inválido se esta função devolver false.
+ * @param d Ponteiro para o descodificador.
+ * @return true se o ficheiro foi lido até ao fim e a soma de verificação coincide, false caso contrário.
+ */
+bool fecharDescodificador(DescodificadorBinario* d) {
+    if (!d || !d->f) return false;
+    bool ok = verificarDescodificador(d);
+    fclose(d->f);
+    free(d->bloco);
+    d->f = NULL;
+    d->bloco = NULL;
+    return ok;
+}
+
+/**
+ * @brief Lê um ficheiro compactado já aberto para o grafo.
+ * @details Os registos são todos descodificados e verificados antes de o grafo ser alterado, e depois
+ *          carregados com inserirAntenasLote (com o índice de posições dimensionado para eles); se faltar
+ *          memória a meio, o grafo fica vazio.
+ * @param f Ficheiro (fica aberto).
+ * @param g Ponteiro para o grafo.
+ * @return true se leu, false se o ficheiro estiver corrompido ou em caso de erro.
+ */
+static bool lerBinarioCompactado(FILE* f, Grafo* g) {
+    DescodificadorBinario d;
+    if (fseek(f, 0, SEEK_SET) != 0 || !iniciarDescodificador(&d, f)) return false;
+
+    // O vetor cresce com os registos lidos, sem confiar no número do cabeçalho para reservar memória
+    RegistoAntena* registos = NULL;
+    int num = 0, capacidade = 0;
+    RegistoAntena r;
+    bool ok = true;
+    while (ok && lerRegistoDescodificador(&d, &r)) {
+        ok = acrescentarRegisto(&registos, &num, &capacidade, r.frequencia, r.linha, r.coluna);
+    }
+    ok = ok && verificarDescodificador(&d) && d.linhas >= 0 && d.colunas >= 0;
+    free(d.bloco);
+    if (!ok) {
+        free(registos);
+        return false;
+    }
+
+    // Limpa o grafo antes de ler (liberta as arenas de uma vez)
+    limparGrafo(g);
+    if (g->verbosidade >= 1) printf("Número de antenas no ficheiro: %d\n", num);
+    if (g->verbosidade >= 2) {
+        for (int i = 0; i < num; i++)
+            printf("freq=%c, linha=%d, coluna=%d\n", registos[i].frequencia, registos[i].linha, registos[i].coluna);
+    }
+    ok = prepararDimensoesGrafo(g, d.linhas, d.colunas, num) && inserirAntenasLote(g, registos, num) >= 0;
+    // Sem memória para terminar: não fica um grafo carregado a meio
+    if (!ok) limparGrafo(g);
+    free(registos);
+    return ok;
+}
+
+/**
+ * @brief Conta os bytes do ficheiro que faltam ler a partir da posição atual.
+ * @details Serve para validar os números de registos de um cabeçalho antes de reservar memória para eles.
+ * @param f Ficheiro (a posição atual não muda).
+ * @return Número de bytes restantes, ou -1 em caso de erro.
+ */
+static long long bytesRestantes(FILE* f) {
+    long atual = ftell(f);
+    if (atual < 0 || fseek(f, 0, SEEK_END) != 0) return -1;
+    long fim = ftell(f);
+    if (fim < 0 || fseek(f, atual, SEEK_SET) != 0) return -1;
+    return (long long)fim - atual;
+}
+
+/**
+ * @brief Lê de uma vez um bloco de bytes do ficheiro para memória.
+ * @param f Ficheiro.
+ * @param tamanho Número de bytes a ler.
+ * @return Bytes lidos (libertar com free), ou NULL se o ficheiro for mais curto ou faltar memória.
+ */
+static unsigned char* lerBytes(FILE* f, size_t tamanho) {
+    unsigned char* dados = malloc(tamanho ? tamanho : 1);
+    if (!dados) return NULL;
+    if (fread(dados, 1, tamanho, f) != tamanho) {
+        free(dados);
+        return NULL;
+    }
+    return dados;
+}
+
+/**
+ * @brief Lê o resto de um ficheiro binário v2 (depois do cabeçalho) para o grafo.
+ * @details Os números de antenas e arestas do cabeçalho têm de corresponder ao tamanho do ficheiro antes de
+ *          ser reservada memória para eles. Os dados são lidos e verificados (soma de verificação, ids das
+ *          arestas) antes de o grafo ser alterado; se faltar memória a meio do carregamento, o grafo fica vazio.
+ * @param f Ficheiro, posicionado depois do cabeçalho.
+ * @param cabecalho Cabeçalho já lido.
+ * @param g Ponteiro para o grafo.
+ * @return true se leu, false se o ficheiro estiver corrompido ou em caso de erro.
+ */
+static bool lerBinarioV2(FILE* f, const unsigned char* cabecalho, Grafo* g) {
+    if (lerU32(cabecalho + 4) != BINARIO_VERSAO) return false;
+    uint32_t linhasLidas = lerU32(cabecalho + 8);
+    uint32_t colunasLidas = lerU32(cabecalho + 12);
+    uint32_t numAntenas = lerU32(cabecalho + 16);
+    uint32_t numArestas = lerU32(cabecalho + 20);
+    uint32_t opcoes = lerU32(cabecalho + 24);
+    // Dimensões acima de INT32_MAX ficariam negativas em int: o ficheiro é rejeitado antes de tocar no grafo
+    if (linhasLidas > INT32_MAX || colunasLidas > INT32_MAX) return false;
+    if (numAntenas > INT32_MAX / BINARIO_REGISTO || numArestas > INT32_MAX / BINARIO_ARESTA) return false;
+    int linhas = (int)linhasLidas;
+    int colunas = (int)colunasLidas;
+    // O ficheiro tem de ter exatamente os registos e arestas anunciados
+    if (bytesRestantes(f) != (long long)numAntenas * BINARIO_REGISTO + (long long)numArestas * BINARIO_ARESTA) return false;
+
+    unsigned char* registos = lerBytes(f, (size_t)numAntenas * BINARIO_REGISTO);
+    if (!registos) return false;
+    unsigned char* arestas = lerBytes(f, (size_t)numArestas * BINARIO_ARESTA);
+    if (!arestas) {
+        free(registos);
+        return false;
+    }
+    uint32_t soma = somaVerificacao(2166136261u, cabecalho, BINARIO_CABECALHO_SOMADO);
+    soma = somaVerificacao(soma, registos, (size_t)numAntenas * BINARIO_REGISTO);
+    soma = somaVerificacao(soma, arestas, (size_t)numArestas * BINARIO_ARESTA);
+    bool ok = soma == lerU32(cabecalho + 28);
+    for (uint32_t a = 0; a < numArestas && ok; a++) {
+        if (lerU32(arestas + a * BINARIO_ARESTA) >= numAntenas || lerU32(arestas + a * BINARIO_ARESTA + 4) >= numAntenas) ok = false;
+    }
+    VAntena** porRegisto = ok ? calloc(numAntenas ? numAntenas : 1, sizeof(VAntena*)) : NULL;
+    // As arestas de cada origem estão pela ordem da lista: acrescentam-se no fim para a manter
+    Adjacente** ultima = porRegisto ? calloc(numAntenas ? numAntenas : 1, sizeof(Adjacente*)) : NULL;
+    if (!ultima) {
+        free(porRegisto);
+        free(registos);
+        free(arestas);
+        return false;
+    }
+
+    // Limpa o grafo antes de ler (liberta as arenas de uma vez)
+    limparGrafo(g);
+    ok = prepararDimensoesGrafo(g, linhas, colunas, (int)numAntenas);
+    if (g->verbosidade >= 1) printf("Número de antenas no ficheiro: %u\n", numAntenas);
+
+    for (uint32_t i = 0; i < numAntenas && ok; i++) {
+        const unsigned char* r = registos + (size_t)i * BINARIO_REGISTO;
+        char freq = (char)r[0];
+        int linha = (int)lerU32(r + 1);
+        int coluna = (int)lerU32(r + 5);
+        if (posicaoOcupada(g, linha, coluna)) continue;
+        VAntena* nova = novoVertice(g, freq, linha, coluna);
+        if (nova && registarVertice(g, nova)) porRegisto[i] = nova;
+        else {
+            if (nova) libertarVertice(nova);
+            ok = false;
+        }
+        if (g->verbosidade >= 2) printf("freq=%c, linha=%d, coluna=%d\n", freq, linha, coluna);
+    }
+
+    for (uint32_t a = 0; a < numArestas && ok; a++) {
+        uint32_t o = lerU32(arestas + a * BINARIO_ARESTA);
+        VAntena* origem = porRegisto[o];
+        VAntena* destino = porRegisto[lerU32(arestas + a * BINARIO_ARESTA + 4)];
+        if (!origem || !destino) continue;
+        Adjacente* novo = (Adjacente*)reservarArena(&g->arenaAdjacentes);
+        if (!novo) {
+            ok = false;
+            break;
+        }
+        METRICA_CONTAR(g, adjacentesReservados, 1);
+        novo->destino = destino;
+        novo->proximo = NULL;
+        if (ultima[o]) ultima[o]->proximo = novo;
+        else origem->listaAdj = novo;
+        ultima[o] = novo;
+    }
+    g->componentesValidos = false;
+    if (ok && (opcoes & BINARIO_FREQUENCIAS_LIGADAS)) ok = conectarAntenasMesmoTipo(g);
+    // Sem memória para terminar: não fica um grafo carregado a meio
+    if (!ok) limparGrafo(g);
+
+    free(ultima);
+    free(porRegisto);
+    free(registos);
+    free(arestas);
+    return ok;
+}
+
+/**
+ * @brief Corpo de lerBinario, sem a medição de tempo (ver lerBinario).
+ */
+static bool lerBinarioInterno(const char* filename, Grafo* g) {
+    if (!g) return false;
     FILE* f = fopen(filename, "rb");
     if (!f) {
         return false;
     }
 
-    // Limpa o grafo antes de ler
-    while (g->listaAntenas) {
-        removerVertice(g, g->listaAntenas->frequencia, g->listaAntenas->linha, g->listaAntenas->coluna);
+    unsigned char cabecalho[BINARIO_CABECALHO];
+    size_t lidos = fread(cabecalho, 1, BINARIO_CABECALHO, f);
+    if (lidos == BINARIO_CABECALHO && memcmp(cabecalho, BINARIO_MAGICO, 4) == 0) {
+        bool ok = lerBinarioV2(f, cabecalho, g);
+        METRICA_CONTAR(g, bytesLidos, ftell(f));
+        fclose(f);
+        return ok;
+    }
+    if (lidos >= COMPACTO_CABECALHO && memcmp(cabecalho, COMPACTO_MAGICO, 4) == 0) {
+        bool ok = lerBinarioCompactado(f, g);
+        METRICA_CONTAR(g, bytesLidos, ftell(f));
+        fclose(f);
+        return ok;
+    }
+    // Formato antigo: volta ao início do ficheiro
+    if (lidos < sizeof(int) || fseek(f, 0, SEEK_SET) != 0) {
+        fclose(f);
+        return false;
     }
 
     int numAntenas = 0;
-    fread(&numAntenas, sizeof(int), 1, f);
-    printf("Número de antenas no ficheiro: %d\n", numAntenas);
-
-    for (int i = 0; i < numAntenas; i++) {
-        char freq;
-        int linha, coluna;
-        fread(&freq, sizeof(char), 1, f);
-        fread(&linha, sizeof(int), 1, f);
-        fread(&coluna, sizeof(int), 1, f);
-        inserirAntena(g, freq, linha, coluna);
-        printf("freq=%c, linha=%d, coluna=%d\n", freq, linha, coluna);
+    if (fread(&numAntenas, sizeof(int), 1, f) != 1 || numAntenas < 0) {
+        fclose(f);
+        return false;
     }
 
+    // Lê todos os registos antes de alterar o grafo (o número do ficheiro não pode exceder o que lá está)
+    const size_t tamanhoRegisto = sizeof(char) + 2 * sizeof(int);
+    long long restantes = bytesRestantes(f);
+    if (restantes < 0 || (long long)numAntenas * (long long)tamanhoRegisto > restantes) {
+        fclose(f);
+        return false;
+    }
+    unsigned char* bloco = malloc(BLOCO_BINARIO * tamanhoRegisto);
+    RegistoAntena* registos = malloc((size_t)(numAntenas ? numAntenas : 1) * sizeof(RegistoAntena));
+    bool ok = bloco && registos;
+    for (int i = 0; i < numAntenas && ok; ) {
+        size_t pedidos = (size_t)(numAntenas - i) < BLOCO_BINARIO ? (size_t)(numAntenas - i) : BLOCO_BINARIO;
+        size_t recebidos = fread(bloco, tamanhoRegisto, pedidos, f);
+        if (recebidos < pedidos) ok = false;
+        for (size_t r = 0; r < recebidos; r++, i++) {
+            const unsigned char* registo = bloco + r * tamanhoRegisto;
+            registos[i].frequencia = (char)registo[0];
+            memcpy(&registos[i].linha, registo + 1, sizeof(int));
+            memcpy(&registos[i].coluna, registo + 1 + sizeof(int), sizeof(int));
+        }
+    }
+    free(bloco);
+    METRICA_CONTAR(g, bytesLidos, ftell(f));
     fclose(f);
-    return true;
+    if (!ok) {
+        free(registos);
+        return false;
+    }
+
+    // Limpa o grafo antes de ler (liberta as arenas de uma vez)
+    limparGrafo(g);
+    if (g->verbosidade >= 1) printf("Número de antenas no ficheiro: %d\n", numAntenas);
+    if (g->verbosidade >= 2) {
+        for (int i = 0; i < numAntenas; i++)
+            printf("freq=%c, linha=%d, coluna=%d\n", registos[i].frequencia, registos[i].linha, registos[i].coluna);
+    }
+    ok = inserirAntenasLote(g, registos, numAntenas) >= 0;
+    if (!ok) limparGrafo(g);
+    free(registos);
+    return ok;
+}
+
+/**
+ * @brief Lê um grafo de um ficheiro binário.
+ * @details Reconhece o formato v2 pelo cabeçalho "EDAG" e o compactado pelo cabeçalho "EDAC"
+ *          (guardarBinarioCompactado); caso contrário lê o formato antigo
+ *          (número de antenas seguido de registos), também em blocos. Os dados são lidos por completo antes de
+ *          o grafo ser esvaziado (com limparGrafo, numa só passagem) e carregado com inserirAntenasLote.
+ *          Os números de registos dos cabeçalhos são validados contra o tamanho do ficheiro antes de reservar
+ *          memória; se a memória faltar depois de o grafo ser esvaziado, o grafo fica vazio.
+ *          As mensagens de diagnóstico dependem de g->verbosidade (definirVerbosidade).
+ * @param filename Nome do ficheiro binário.
+ * @param g Ponteiro para o grafo.
+ * @return true se leu, false caso contrário.
+ */
+// Ler do ficheiro binário
+
+bool lerBinario(const char* filename, Grafo* g) {
+    METRICA_INICIO(inicio);
+    bool r = lerBinarioInterno(filename, g);
+    METRICA_FIM(g, METRICA_LER_BINARIO, inicio);
+    return r;
 }
 
 
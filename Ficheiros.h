@@ -22,6 +22,27 @@
  */
 bool lerMatrizAntenas(Grafo* g, const char* filename, int* linhas, int* colunas);
 
+/**
+ * @brief Lê um mapa de antenas em formato esparso ("freq,linha,coluna" por linha) e insere no grafo.
+ * @param g Ponteiro para o grafo.
+ * @param filename Nome do ficheiro de texto.
+ * @param linhas Ponteiro para guardar o número de linhas.
+ * @param colunas Ponteiro para guardar o número de colunas.
+ * @return true se leu e inseriu com sucesso, false caso contrário.
+ */
+bool lerMapaEsparso(Grafo* g, const char* filename, int* linhas, int* colunas);
+
+/**
+ * @brief Escreve o mapa em formato esparso: dimensões, antenas e (opcionalmente) efeitos nefastos ('#').
+ * @param filename Nome do ficheiro a escrever.
+ * @param g Ponteiro para o grafo.
+ * @param efeitos Lista de efeitos nefastos (NULL para escrever só as antenas).
+ * @param linhas Número de linhas do mapa.
+ * @param colunas Número de colunas do mapa.
+ * @return true se escreveu, false caso contrário.
+ */
+bool escreverMapaEsparso(const char* filename, Grafo* g, EfeitoNefasto* efeitos, int linhas, int colunas);
+
 /**
  * @brief Guarda o grafo em ficheiro binário.
  * @param filename Nome do ficheiro binário.
@@ -31,7 +52,48 @@ bool lerMatrizAntenas(Grafo* g, const char* filename, int* linhas, int* colunas)
 bool guardarBinario(const char* filename, Grafo* g);
 
 /**
- * @brief Lê o grafo de um ficheiro binário.
+ * @brief Guarda o grafo num ficheiro binário no formato v2 (cabeçalho, registos compactos e arestas opcionais).
+ * @param filename Nome do ficheiro binário.
+ * @param g Ponteiro para o grafo.
+ * @param incluirArestas true para guardar também as adjacências.
+ * @return true se guardou, false caso contrário.
+ */
+bool guardarBinarioV2(const char* filename, Grafo* g, bool incluirArestas);
+
+/**
+ * @brief Guarda o grafo num ficheiro binário compactado (antenas agrupadas por frequência, ordenadas por
+ *        linha e coluna, com as coordenadas em diferenças varint; sem arestas).
+ * @param filename Nome do ficheiro binário.
+ * @param g Ponteiro para o grafo.
+ * @return true se guardou, false caso contrário.
+ */
+bool guardarBinarioCompactado(const char* filename, Grafo* g);
+
+/**
+ * @brief Abre um ficheiro binário compactado para o descodificar registo a registo.
+ * @param d Ponteiro para o descodificador.
+ * @param filename Nome do ficheiro binário.
+ * @return true se abriu, false caso contrário.
+ */
+bool abrirDescodificador(DescodificadorBinario* d, const char* filename);
+
+/**
+ * @brief Descodifica o próximo registo de antena do ficheiro compactado.
+ * @param d Ponteiro para o descodificador.
+ * @param r Ponteiro para guardar o registo.
+ * @return true se leu um registo, false no fim ou em caso de erro.
+ */
+bool lerRegistoDescodificador(DescodificadorBinario* d, RegistoAntena* r);
+
+/**
+ * @brief Fecha o ficheiro compactado e verifica que foi lido por completo e sem erros.
+ * @param d Ponteiro para o descodificador.
+ * @return true se o ficheiro estava completo e intacto, false caso contrário.
+ */
+bool fecharDescodificador(DescodificadorBinario* d);
+
+/**
+ * @brief Lê o grafo de um ficheiro binário (formato v2, compactado ou antigo, detetado pelo cabeçalho).
  * @param filename Nome do ficheiro binário.
  * @param g Ponteiro para o grafo.
  * @return true se leu, false caso contrário.
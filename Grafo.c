@@ -4,11 +4,18 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <string.h>
+#include <limits.h>
 #include <math.h>
 #include "Antena.h"
 #include "Grafo.h"
 #include "Nefasto.h"
 #include "Ficheiros.h"
+#include "Indice.h"
+#include "Memoria.h"
+#include "Metricas.h"
+#include "Espacial.h"
+#include "Diario.h"
 
 /**
  * @file Grafo.c
@@ -30,9 +37,390 @@ Grafo* criarGrafo() {
     if (!g) return NULL;
     g->listaAntenas = NULL;
     g->numAntenas = 0;
+    g->vertices = NULL;
+    g->capacidadeVertices = 0;
+    g->linhas = 0;
+    g->colunas = 0;
+    iniciarIndice(&g->indice);
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+        g->baldes[f].antenas = NULL;
+        g->baldes[f].numAntenas = 0;
+        g->baldes[f].capacidade = 0;
+        g->baldes[f].porLinha = NULL;
+        g->baldes[f].capacidadePorLinha = 0;
+        g->baldes[f].porLinhaValido = false;
+    }
+    iniciarArena(&g->arenaVertices, sizeof(VAntena));
+    iniciarArena(&g->arenaAdjacentes, sizeof(Adjacente));
+    g->arestasImplicitas = false;
+    g->frequenciasLigadas = false;
+    g->componentesValidos = false;
+    g->numComponentes = 0;
+    g->tamanhosComponentes = NULL;
+    g->representantes = NULL;
+    iniciarEfeitosIncrementais(&g->efeitos);
+    g->verbosidade = 0;
+    reiniciarMetricas(g);
+    g->espacial.raiz = NULL;
+    g->diario = NULL;
     return g;
 }
 
+/**
+ * @brief Esvazia o grafo, libertando todas as antenas e adjacências de uma vez.
+ * @details As arenas são libertadas bloco a bloco; o grafo continua válido (e com as mesmas dimensões).
+ * @param g Ponteiro para o grafo.
+ * @return true após esvaziar, false se o grafo for inválido.
+ */
+bool limparGrafo(Grafo* g) {
+    if (!g) return false;
+    libertarArena(&g->arenaVertices);
+    libertarArena(&g->arenaAdjacentes);
+    g->listaAntenas = NULL;
+    g->numAntenas = 0;
+    g->frequenciasLigadas = false;
+    g->componentesValidos = false;
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+        g->baldes[f].numAntenas = 0;
+        g->baldes[f].porLinhaValido = false;
+    }
+    libertarEfeitosIncrementais(&g->efeitos);
+    libertarIndiceEspacial(g);
+    libertarIndice(&g->indice);
+    definirLimitesIndice(&g->indice, g->linhas, g->colunas, 0);
+    if (g->diario) {
+        registarDiario(g, DIARIO_LIMPAR, NULL);
+        confirmarDiario(g);
+    }
+    return true;
+}
+
+/**
+ * @brief Destrói o grafo, libertando toda a memória associada (incluindo o próprio grafo).
+ * @param g Ponteiro para o grafo.
+ * @return true após destruir, false se o grafo for inválido.
+ */
+bool destruirGrafo(Grafo* g) {
+    if (!g) return false;
+    libertarArena(&g->arenaVertices);
+    libertarArena(&g->arenaAdjacentes);
+    libertarIndice(&g->indice);
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+        free(g->baldes[f].antenas);
+        free(g->baldes[f].porLinha);
+    }
+    free(g->vertices);
+    free(g->tamanhosComponentes);
+    free(g->representantes);
+    libertarEfeitosIncrementais(&g->efeitos);
+    libertarIndiceEspacial(g);
+    if (g->diario) fecharDiario(g);
+    free(g);
+    return true;
+}
+
+/**
+ * @brief Reserva e inicializa uma antena na arena do grafo, sem a ligar ao grafo.
+ * @param g Ponteiro para o grafo.
+ * @param freq Frequência da antena.
+ * @param linha Linha da antena.
+ * @param coluna Coluna da antena.
+ * @return Ponteiro para a antena, ou NULL em caso de erro.
+ */
+VAntena* novoVertice(Grafo* g, char freq, int linha, int coluna) {
+    if (!g) return NULL;
+    VAntena* nova = (VAntena*)reservarArena(&g->arenaVertices);
+    if (!nova) return NULL;
+    METRICA_CONTAR(g, verticesReservados, 1);
+    nova->frequencia = freq;
+    nova->linha = linha;
+    nova->coluna = coluna;
+    nova->visitado = false;
+    nova->listaAdj = NULL;
+    nova->proximo = NULL;
+    nova->anterior = NULL;
+    nova->posicaoBalde = -1;
+    nova->id = -1;
+    nova->componente = -1;
+    nova->ligadaFrequencia = false;
+    nova->grafo = g;
+    return nova;
+}
+
+/**
+ * @brief Liberta uma antena (devolve-a à arena do grafo, ou free se foi criada com malloc).
+ * @param ant Ponteiro para a antena (já desligada do grafo).
+ * @return true após libertar.
+ */
+bool libertarVertice(VAntena* ant) {
+    if (!ant) return false;
+    if (ant->grafo)
+        devolverArena(&ant->grafo->arenaVertices, ant);
+    else
+        free(ant);
+    return true;
+}
+
+/**
+ * @brief Liberta um nó de adjacência da antena de origem.
+ * @param origem Antena dona da lista de adjacências.
+ * @param adj Nó a libertar.
+ */
+static void libertarAdjacente(VAntena* origem, Adjacente* adj) {
+    if (origem->grafo)
+        devolverArena(&origem->grafo->arenaAdjacentes, adj);
+    else
+        free(adj);
+}
+
+/**
+ * @brief Define as dimensões do mapa associado ao grafo.
+ * @details Com as dimensões conhecidas, o índice de posições pode passar a usar uma grelha densa.
+ * @param g Ponteiro para o grafo.
+ * @param linhas Número de linhas do mapa.
+ * @param colunas Número de colunas do mapa.
+ * @return true se definiu, false caso contrário.
+ */
+bool definirDimensoesGrafo(Grafo* g, int linhas, int colunas) {
+    return prepararDimensoesGrafo(g, linhas, colunas, 0);
+}
+
+/**
+ * @brief Define as dimensões do mapa antes de carregar um número conhecido de antenas.
+ * @details A escolha entre grelha densa e tabela de dispersão conta com as antenas já no grafo mais as
+ *          que vão ser inseridas, para um mapa grande e denso lido de um ficheiro ficar logo na grelha.
+ * @param g Ponteiro para o grafo.
+ * @param linhas Número de linhas do mapa.
+ * @param colunas Número de colunas do mapa.
+ * @param numAntenasPrevistas Número de antenas que vão ser inseridas a seguir.
+ * @return true se definiu, false caso contrário (dimensões inválidas ou erro de memória).
+ */
+bool prepararDimensoesGrafo(Grafo* g, int linhas, int colunas, int numAntenasPrevistas) {
+    if (!g || linhas < 0 || colunas < 0 || numAntenasPrevistas < 0) return false;
+    long long previstas = (long long)g->numAntenas + numAntenasPrevistas;
+    if (previstas > INT_MAX) previstas = INT_MAX;
+    if (!definirLimitesIndice(&g->indice, linhas, colunas, (int)previstas)) return false;
+    g->linhas = linhas;
+    g->colunas = colunas;
+    return true;
+}
+
+/**
+ * @brief Devolve o balde de frequência de uma antena.
+ * @param g Ponteiro para o grafo.
+ * @param freq Frequência.
+ * @return Ponteiro para o balde.
+ */
+BaldeFrequencia* baldeFrequencia(Grafo* g, char freq) {
+    if (!g) return NULL;
+    return &g->baldes[(unsigned char)freq];
+}
+
+/**
+ * @brief Compara duas antenas por (linha, coluna), para qsort.
+ * @param a Ponteiro para o primeiro VAntena*.
+ * @param b Ponteiro para o segundo VAntena*.
+ * @return Negativo, zero ou positivo, como em strcmp.
+ */
+static int compararPorLinha(const void* a, const void* b) {
+    const VAntena* x = *(VAntena* const*)a;
+    const VAntena* y = *(VAntena* const*)b;
+    if (x->linha != y->linha) return x->linha < y->linha ? -1 : 1;
+    if (x->coluna != y->coluna) return x->coluna < y->coluna ? -1 : 1;
+    return 0;
+}
+
+/**
+ * @brief Garante que a cópia do balde ordenada por (linha, coluna) (BaldeFrequencia::porLinha) está atualizada.
+ * @details A cópia só é refeita se o balde mudou desde a última vez.
+ * @param b Ponteiro para o balde.
+ * @return true se a cópia está pronta, false em caso de erro de memória.
+ */
+bool ordenarBaldePorLinha(BaldeFrequencia* b) {
+    if (b->porLinhaValido) return true;
+    if (b->capacidadePorLinha < b->numAntenas) {
+        VAntena** novo = realloc(b->porLinha, (size_t)b->capacidade * sizeof(VAntena*));
+        if (!novo) return false;
+        b->porLinha = novo;
+        b->capacidadePorLinha = b->capacidade;
+    }
+    if (b->numAntenas > 0) {
+        memcpy(b->porLinha, b->antenas, (size_t)b->numAntenas * sizeof(VAntena*));
+        qsort(b->porLinha, (size_t)b->numAntenas, sizeof(VAntena*), compararPorLinha);
+    }
+    b->porLinhaValido = true;
+    return true;
+}
+
+/**
+ * @brief Acrescenta uma antena ao balde da sua frequência.
+ * @param g Ponteiro para o grafo.
+ * @param ant Ponteiro para a antena.
+ * @return true se acrescentou, false em caso de erro de memória.
+ */
+static bool adicionarBalde(Grafo* g, VAntena* ant) {
+    BaldeFrequencia* b = baldeFrequencia(g, ant->frequencia);
+    if (b->numAntenas == b->capacidade) {
+        int capacidade = b->capacidade ? b->capacidade * 2 : 8;
+        VAntena** novo = realloc(b->antenas, (size_t)capacidade * sizeof(VAntena*));
+        if (!novo) return false;
+        b->antenas = novo;
+        b->capacidade = capacidade;
+    }
+    ant->posicaoBalde = b->numAntenas;
+    b->antenas[b->numAntenas++] = ant;
+    b->porLinhaValido = false;
+    return true;
+}
+
+/**
+ * @brief Retira uma antena do balde da sua frequência (troca com a última).
+ * @param g Ponteiro para o grafo.
+ * @param ant Ponteiro para a antena.
+ */
+static void retirarBalde(Grafo* g, VAntena* ant) {
+    BaldeFrequencia* b = baldeFrequencia(g, ant->frequencia);
+    VAntena* ultima = b->antenas[--b->numAntenas];
+    b->antenas[ant->posicaoBalde] = ultima;
+    ultima->posicaoBalde = ant->posicaoBalde;
+    ant->posicaoBalde = -1;
+    b->porLinhaValido = false;
+}
+
+/**
+ * @brief Liga uma antena já criada ao grafo (lista de antenas, id denso, índice de posições e balde da frequência).
+ * @param g Ponteiro para o grafo.
+ * @param ant Ponteiro para a antena.
+ * @return true se ligou, false caso contrário.
+ */
+bool registarVertice(Grafo* g, VAntena* ant) {
+    if (!g || !ant) return false;
+    if (g->numAntenas == g->capacidadeVertices) {
+        int capacidade = g->capacidadeVertices ? g->capacidadeVertices * 2 : 16;
+        VAntena** novo = realloc(g->vertices, (size_t)capacidade * sizeof(VAntena*));
+        if (!novo) return false;
+        g->vertices = novo;
+        g->capacidadeVertices = capacidade;
+    }
+    if (!adicionarBalde(g, ant)) return false;
+    if (!registarIndice(&g->indice, ant)) {
+        retirarBalde(g, ant);
+        return false;
+    }
+    if (g->efeitos.ativos) atualizarEfeitosAntena(g, ant, 1);
+    registarEspacial(g, ant);
+
+    ant->anterior = NULL;
+    ant->proximo = g->listaAntenas;
+    if (g->listaAntenas) g->listaAntenas->anterior = ant;
+    g->listaAntenas = ant;
+    ant->id = g->numAntenas;
+    g->vertices[g->numAntenas++] = ant;
+    g->componentesValidos = false;
+    if (g->diario) {
+        registarDiario(g, DIARIO_INSERIR, ant);
+        confirmarDiario(g);
+    }
+    return true;
+}
+
+/**
+ * @brief Liga ao grafo, de uma vez, um conjunto de antenas já criadas (com posições livres e distintas).
+ * @details O vetor de vértices e os baldes de frequência crescem uma só vez para o lote todo; as antenas são
+ *          ligadas pela ordem dada (a lista fica como se fossem inseridas uma a uma) e numAntenas só é
+ *          atualizado no fim. Se faltar memória a meio, ficam ligadas apenas as primeiras.
+ * @param g Ponteiro para o grafo.
+ * @param novas Antenas a ligar (reservadas com novoVertice).
+ * @param num Número de antenas.
+ * @return Número de antenas ligadas (as restantes continuam por ligar e devem ser libertadas), ou -1 em caso de erro.
+ */
+int registarVerticesLote(Grafo* g, VAntena** novas, int num) {
+    if (!g || (!novas && num > 0) || num < 0) return -1;
+    if (num == 0) return 0;
+
+    if (g->numAntenas + num > g->capacidadeVertices) {
+        int capacidade = g->capacidadeVertices ? g->capacidadeVertices : 16;
+        while (capacidade < g->numAntenas + num) capacidade *= 2;
+        VAntena** novo = realloc(g->vertices, (size_t)capacidade * sizeof(VAntena*));
+        if (!novo) return -1;
+        g->vertices = novo;
+        g->capacidadeVertices = capacidade;
+    }
+    // Faz crescer cada balde uma só vez
+    int porFrequencia[NUM_FREQUENCIAS] = { 0 };
+    for (int i = 0; i < num; i++) porFrequencia[(unsigned char)novas[i]->frequencia]++;
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+        BaldeFrequencia* b = &g->baldes[f];
+        if (!porFrequencia[f] || b->numAntenas + porFrequencia[f] <= b->capacidade) continue;
+        int capacidade = b->capacidade ? b->capacidade : 8;
+        while (capacidade < b->numAntenas + porFrequencia[f]) capacidade *= 2;
+        VAntena** novo = realloc(b->antenas, (size_t)capacidade * sizeof(VAntena*));
+        if (!novo) return -1;
+        b->antenas = novo;
+        b->capacidade = capacidade;
+    }
+
+    int ligadas = 0;
+    VAntena* cabeca = g->listaAntenas;
+    for (; ligadas < num; ligadas++) {
+        VAntena* ant = novas[ligadas];
+        if (!adicionarBalde(g, ant)) break;
+        if (!registarIndice(&g->indice, ant)) {
+            retirarBalde(g, ant);
+            break;
+        }
+        if (g->efeitos.ativos) atualizarEfeitosAntena(g, ant, 1);
+        registarEspacial(g, ant);
+        ant->anterior = NULL;
+        ant->proximo = cabeca;
+        if (cabeca) cabeca->anterior = ant;
+        cabeca = ant;
+        ant->id = g->numAntenas + ligadas;
+        g->vertices[ant->id] = ant;
+        if (g->diario) registarDiario(g, DIARIO_INSERIR, ant);
+    }
+    g->listaAntenas = cabeca;
+    g->numAntenas += ligadas;
+    if (ligadas > 0) g->componentesValidos = false;
+    if (g->diario) confirmarDiario(g);
+    return ligadas;
+}
+
+/**
+ * @brief Desliga uma antena do grafo (lista de antenas, id denso, índice de posições e balde da frequência), sem a libertar.
+ * @param g Ponteiro para o grafo.
+ * @param ant Ponteiro para a antena.
+ * @return true se desligou, false caso contrário.
+ */
+bool retirarVertice(Grafo* g, VAntena* ant) {
+    if (!g || !ant) return false;
+    if (g->efeitos.ativos) atualizarEfeitosAntena(g, ant, -1);
+    retirarEspacial(g, ant);
+    retirarIndice(&g->indice, ant->linha, ant->coluna);
+    retirarBalde(g, ant);
+
+    if (ant->anterior)
+        ant->anterior->proximo = ant->proximo;
+    else
+        g->listaAntenas = ant->proximo;
+    if (ant->proximo) ant->proximo->anterior = ant->anterior;
+    ant->anterior = NULL;
+    ant->proximo = NULL;
+
+    // Mantém os ids densos: a última antena passa a ocupar o id libertado
+    VAntena* ultima = g->vertices[--g->numAntenas];
+    g->vertices[ant->id] = ultima;
+    ultima->id = ant->id;
+    ant->id = -1;
+    ant->componente = -1;
+    g->componentesValidos = false;
+    if (g->diario) {
+        registarDiario(g, DIARIO_REMOVER, ant);
+        confirmarDiario(g);
+    }
+    return true;
+}
+
 /**
  * @brief Imprime todas as antenas e as suas ligações do grafo.
  * @param g Ponteiro para o grafo.
@@ -46,32 +434,159 @@ bool imprimirGrafo(Grafo* g) {
     for (VAntena* atual = g->listaAntenas; atual != NULL; atual = atual->proximo, id++) {
         if (atual->frequencia == '#') continue; // Ignora efeitos nefastos
         printf("Antena %c (%d,%d) -> ", atual->frequencia, atual->linha, atual->coluna);
-        for (Adjacente* adj = atual->listaAdj; adj != NULL; adj = adj->proximo) {
-            printf("(%c, %d,%d) ", adj->destino->frequencia, adj->destino->linha, adj->destino->coluna);
+        IteradorVizinhos it;
+        iniciarVizinhos(&it, atual);
+        for (VAntena* v = proximoVizinho(&it); v != NULL; v = proximoVizinho(&it)) {
+            printf("(%c, %d,%d) ", v->frequencia, v->linha, v->coluna);
         }
         printf("\n");
     }
     return true;
 }
 
+/**
+ * @brief Cria os nós Adjacente entre todas as antenas marcadas (ligadaFrequencia) da mesma frequência.
+ * @details As ligações já existentes de cada origem são marcadas (por id denso) antes de acrescentar as
+ *          novas, pelo que não há pesquisa na lista por cada par.
+ * @param g Ponteiro para o grafo.
+ * @return true se ligou, false em caso de erro de memória.
+ */
+static bool materializarLigacoesFrequencia(Grafo* g) {
+    int* marca = malloc((size_t)(g->numAntenas ? g->numAntenas : 1) * sizeof(int));
+    if (!marca) return false;
+    for (int i = 0; i < g->numAntenas; i++) marca[i] = -1;
+
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+        BaldeFrequencia* b = &g->baldes[f];
+        for (int i = 0; i < b->numAntenas; i++) {
+            VAntena* origem = b->antenas[i];
+            if (!origem->ligadaFrequencia) continue;
+            for (Adjacente* adj = origem->listaAdj; adj != NULL; adj = adj->proximo) {
+                if (adj->destino->id >= 0) marca[adj->destino->id] = origem->id;
+            }
+            for (int j = 0; j < b->numAntenas; j++) {
+                VAntena* destino = b->antenas[j];
+                METRICA_CONTAR(g, verificacoesDuplicado, 1);
+                if (i == j || !destino->ligadaFrequencia || marca[destino->id] == origem->id) continue;
+                Adjacente* novo = (Adjacente*)reservarArena(&g->arenaAdjacentes);
+                if (!novo) {
+                    free(marca);
+                    return false;
+                }
+                METRICA_CONTAR(g, adjacentesReservados, 1);
+                novo->destino = destino;
+                novo->proximo = origem->listaAdj;
+                origem->listaAdj = novo;
+            }
+        }
+    }
+    free(marca);
+    return true;
+}
+
+/**
+ * @brief Corpo de conectarAntenasMesmoTipo, sem a medição de tempo (ver conectarAntenasMesmoTipo).
+ */
+static bool conectarAntenasMesmoTipoInterno(Grafo* g) {
+    if (!g || !g->listaAntenas) return false;
+
+    g->componentesValidos = false;
+    // Fixa o conjunto ligado: só as antenas existentes agora, nos dois modos
+    for (int i = 0; i < g->numAntenas; i++) g->vertices[i]->ligadaFrequencia = true;
+    if (g->arestasImplicitas) {
+        g->frequenciasLigadas = true;
+        return true;
+    }
+    // Só antenas do mesmo balde podem ser ligadas
+    return materializarLigacoesFrequencia(g);
+}
+
 /**
  * @brief Conecta automaticamente antenas do mesmo tipo.
+ * @details Com arestas implícitas não é criado nenhum nó: as antenas existentes são marcadas e as ligações
+ *          entre marcadas passam a ser dadas pelos baldes de frequência, com memória O(k) em vez de O(k²) por
+ *          frequência. Nos dois modos, antenas inseridas depois da chamada não ficam ligadas.
  * @param g Ponteiro para o grafo.
  * @return true se conectou, false se o grafo está vazio.
  */
 bool conectarAntenasMesmoTipo(Grafo* g) {
-    if (!g || !g->listaAntenas) return false;
+    METRICA_INICIO(inicio);
+    bool r = conectarAntenasMesmoTipoInterno(g);
+    METRICA_FIM(g, METRICA_CONECTAR, inicio);
+    return r;
+}
 
-    for (VAntena* atual = g->listaAntenas; atual != NULL; atual = atual->proximo) {
-        for (VAntena* outro = g->listaAntenas; outro != NULL; outro = outro->proximo) {
-            if (atual != outro && atual->frequencia == outro->frequencia) {
-                inserirAdjacente(atual, outro);
-            }
-        }
+/**
+ * @brief Ativa ou desativa as ligações implícitas entre antenas da mesma frequência.
+ * @details Ao desativar, se as frequências já estavam ligadas, as ligações entre as antenas marcadas são
+ *          materializadas em nós Adjacente, para o grafo observável não mudar.
+ * @param g Ponteiro para o grafo.
+ * @param implicitas true para ligações implícitas.
+ * @return true se alterou o modo, false em caso de erro.
+ */
+bool definirArestasImplicitas(Grafo* g, bool implicitas) {
+    if (!g) return false;
+    if (!implicitas && g->frequenciasLigadas) {
+        if (!materializarLigacoesFrequencia(g)) return false;
+        g->frequenciasLigadas = false;
     }
+    g->arestasImplicitas = implicitas;
     return true;
 }
 
+/**
+ * @brief Define o nível de mensagens de diagnóstico das leituras de ficheiros.
+ * @param g Ponteiro para o grafo.
+ * @param nivel 0 para nenhuma, 1 para um resumo, 2 para uma linha por antena lida.
+ * @return true se definiu, false se o grafo for inválido.
+ */
+bool definirVerbosidade(Grafo* g, int nivel) {
+    if (!g) return false;
+    g->verbosidade = nivel;
+    return true;
+}
+
+/**
+ * @brief Prepara um iterador sobre os vizinhos de uma antena.
+ * @param it Ponteiro para o iterador.
+ * @param origem Antena cujos vizinhos se querem percorrer.
+ * @return true se preparou, false caso contrário.
+ */
+bool iniciarVizinhos(IteradorVizinhos* it, VAntena* origem) {
+    if (!it) return false;
+    it->origem = origem;
+    it->adj = origem ? origem->listaAdj : NULL;
+    it->posicaoBalde = 0;
+    it->implicito = origem && origem->grafo && origem->grafo->frequenciasLigadas && origem->ligadaFrequencia &&
+                    origem->posicaoBalde >= 0;
+    return origem != NULL;
+}
+
+/**
+ * @brief Devolve o próximo vizinho de um iterador.
+ * @details Com ligações implícitas e a origem marcada, as adjacências explícitas para antenas marcadas da mesma
+ *          frequência são saltadas (já estão incluídas no balde), para nenhum vizinho aparecer repetido.
+ * @param it Ponteiro para o iterador.
+ * @return Ponteiro para o vizinho, ou NULL quando não há mais.
+ */
+VAntena* proximoVizinho(IteradorVizinhos* it) {
+    if (!it || !it->origem) return NULL;
+
+    while (it->adj) {
+        VAntena* destino = it->adj->destino;
+        it->adj = it->adj->proximo;
+        if (!it->implicito || !destino->ligadaFrequencia || destino->frequencia != it->origem->frequencia) return destino;
+    }
+    if (!it->implicito) return NULL;
+
+    BaldeFrequencia* b = baldeFrequencia(it->origem->grafo, it->origem->frequencia);
+    while (it->posicaoBalde < b->numAntenas) {
+        VAntena* destino = b->antenas[it->posicaoBalde++];
+        if (destino != it->origem && destino->ligadaFrequencia) return destino;
+    }
+    return NULL;
+}
+
 /**
  * @brief Insere uma adjacência (ligação) entre duas antenas.
  * @param origem Ponteiro para a antena de origem.
@@ -83,18 +598,23 @@ bool inserirAdjacente(VAntena* origem, VAntena* destino) {
     if (origem == destino) return false; // Impede auto-adjacências
     // Verifica se já existe ligação
     for (Adjacente* adj = origem->listaAdj; adj != NULL; adj = adj->proximo) {
+        if (origem->grafo) METRICA_CONTAR(origem->grafo, verificacoesDuplicado, 1);
         if (adj->destino == destino) return false;
     }
-    Adjacente* novo = (Adjacente*)malloc(sizeof(Adjacente));
+    Adjacente* novo = origem->grafo ? (Adjacente*)reservarArena(&origem->grafo->arenaAdjacentes)
+                                    : (Adjacente*)malloc(sizeof(Adjacente));
     if (!novo) return false;
+    if (origem->grafo) METRICA_CONTAR(origem->grafo, adjacentesReservados, 1);
     novo->destino = destino;
     novo->proximo = origem->listaAdj;
     origem->listaAdj = novo;
+    if (origem->grafo) origem->grafo->componentesValidos = false;
     return true;
 }
 
 /**
  * @brief Remove a ligação de origem para destino.
+ * @details Ligações implícitas entre antenas da mesma frequência não têm nó e não podem ser removidas uma a uma.
  * @param origem Ponteiro para a antena de origem.
  * @param destino Ponteiro para a antena de destino.
  * @return true se a ligação foi removida, false se não existia.
@@ -113,7 +633,8 @@ bool removerAdjacente(VAntena* origem, VAntena* destino) {
                 origem->listaAdj = atual->proximo;
             else
                 anterior->proximo = atual->proximo;
-            free(atual);
+            libertarAdjacente(origem, atual);
+            if (origem->grafo) origem->grafo->componentesValidos = false;
             return true;
         }
         anterior = atual;
@@ -133,24 +654,20 @@ bool removerAdjacente(VAntena* origem, VAntena* destino) {
 VAntena* inserirVertice(Grafo* g, char freq, int linha, int coluna) {
     if (!g) return NULL;
     // Verifica se já existe antena nesta posição
-    for (VAntena* a = g->listaAntenas; a != NULL; a = a->proximo) {
-        if (a->linha == linha && a->coluna == coluna) return NULL;
-    }
-    VAntena* nova = (VAntena*)malloc(sizeof(VAntena));
+    if (consultarIndice(&g->indice, linha, coluna)) return NULL;
+    VAntena* nova = novoVertice(g, freq, linha, coluna);
     if (!nova) return NULL;
-    nova->frequencia = freq;
-    nova->linha = linha;
-    nova->coluna = coluna;
-    nova->visitado = 0;
-    nova->listaAdj = NULL;
-    nova->proximo = g->listaAntenas;
-    g->listaAntenas = nova;
-    g->numAntenas++;
+    if (!registarVertice(g, nova)) {
+        libertarVertice(nova);
+        return NULL;
+    }
     return nova;
 }
 
 /**
  * @brief Remove um vértice (antena) do grafo, removendo também todas as adjacências para ele.
+ * @details As listas dos outros vértices só são percorridas se houver nós Adjacente que não sejam do próprio
+ *          vértice (a arena conta os nós em uso); sem ligações explícitas a remoção não depende do número de antenas.
  * @param g Ponteiro para o grafo.
  * @param freq Frequência da antena a remover.
  * @param linha Linha da antena a remover.
@@ -160,37 +677,30 @@ VAntena* inserirVertice(Grafo* g, char freq, int linha, int coluna) {
 bool removerVertice(Grafo* g, char freq, int linha, int coluna) {
     if (!g || !g->listaAntenas) return false;// Grafo vazio
 
-    VAntena* atual = g->listaAntenas;
-    VAntena* percorrer = g->listaAntenas;
-    VAntena* anterior = NULL;
+    VAntena* atual = procurarAntena(g, freq, linha, coluna);
+    if (!atual) return false;
 
-    
-    while (atual) {
-        if (atual->frequencia == freq && atual->linha == linha && atual->coluna == coluna) {
-            // Remove todas as adjacências de outros vértices para este
-            for (percorrer = g->listaAntenas; percorrer != NULL; percorrer = percorrer->proximo) {
+    // Remove todas as adjacências de outros vértices para este (só as do próprio vértice, se forem todas dele)
+    if (g->arenaAdjacentes.numObjetos > 0) {
+        int proprias = 0;
+        for (Adjacente* adj = atual->listaAdj; adj != NULL; adj = adj->proximo) proprias++;
+        if (g->arenaAdjacentes.numObjetos > proprias) {
+            for (VAntena* percorrer = g->listaAntenas; percorrer != NULL; percorrer = percorrer->proximo) {
                 if (percorrer != atual) removerAdjacente(percorrer, atual);
             }
-            // Remove adjacências deste vértice
-            Adjacente* adj = atual->listaAdj;
-            while (adj) {
-                Adjacente* temp = adj;
-                adj = adj->proximo;
-                free(temp);
-            }
-            // Remove da lista ligada
-            if (anterior == NULL)
-                g->listaAntenas = atual->proximo;
-            else
-                anterior->proximo = atual->proximo;
-            free(atual);
-            g->numAntenas--;
-            return true;
         }
-        anterior = atual;
-        atual = atual->proximo;
     }
-    return false;
+    // Remove adjacências deste vértice
+    Adjacente* adj = atual->listaAdj;
+    while (adj) {
+        Adjacente* temp = adj;
+        adj = adj->proximo;
+        libertarAdjacente(atual, temp);
+    }
+    // Remove da lista ligada e do índice
+    retirarVertice(g, atual);
+    libertarVertice(atual);
+    return true;
 }
 
 /**
@@ -205,24 +715,66 @@ bool limparVisitados(Grafo* g) {
     return true;
 }
 
+/**
+ * @brief Percorre em profundidade (pré-ordem) a partir de uma antena, sem recursão.
+ * @details Usa uma pilha explícita de iteradores de vizinhos, que cresce conforme necessário; a ordem de
+ *          visita é a mesma da versão recursiva.
+ * @param inicio Antena inicial (ainda não visitada).
+ * @param visitado Vetor indexado pelo id denso das antenas, ou NULL para usar o campo VAntena::visitado.
+ * @param formatoDFS true para o formato de DFS (ignora '#'), false para o de DFS_Antena.
+ * @return true se percorreu, false em caso de erro de memória.
+ */
+static bool percorrerProfundidade(VAntena* inicio, bool* visitado, bool formatoDFS) {
+    int capacidade = 64;
+    int topo = 0;
+    IteradorVizinhos* pilha = malloc((size_t)capacidade * sizeof(IteradorVizinhos));
+    if (!pilha) return false;
+
+    VAntena* v = inicio;
+    while (v) {
+        // Visita v e empilha o iterador dos seus vizinhos
+        if (visitado) visitado[v->id] = true;
+        else v->visitado = true;
+        if (!formatoDFS)
+            printf("Antena %c (%d,%d)\n", v->frequencia, v->linha, v->coluna);
+        else if (v->frequencia != '#')
+            printf("Antena %c (%d,%d) visitada \n", v->frequencia, v->linha, v->coluna);
+
+        if (topo == capacidade) {
+            capacidade *= 2;
+            IteradorVizinhos* nova = realloc(pilha, (size_t)capacidade * sizeof(IteradorVizinhos));
+            if (!nova) {
+                free(pilha);
+                return false;
+            }
+            pilha = nova;
+        }
+        iniciarVizinhos(&pilha[topo++], v);
+
+        // Procura o próximo vizinho por visitar, desempilhando os iteradores esgotados
+        v = NULL;
+        while (topo > 0 && !v) {
+            VAntena* w = proximoVizinho(&pilha[topo - 1]);
+            if (!w)
+                topo--;
+            else if (visitado ? (w->id >= 0 && !visitado[w->id]) : !w->visitado)
+                v = w;
+        }
+    }
+    free(pilha);
+    return true;
+}
+
 /**
  * @brief Executa uma busca em profundidade (DFS) a partir de uma antena.
+ * @details Iterativa: não há limite de profundidade imposto pela pilha de chamadas.
  * @param atual Ponteiro para a antena inicial.
  * @return true se visitou, false caso contrário.
  */
 
- bool DFS(VAntena* atual) {
+bool DFS(VAntena* atual) {
     if (!atual || atual->visitado) return false;
-
-    if (atual->frequencia != '#') {
-        atual->visitado = true;
-        printf("Antena %c (%d,%d) visitada \n", atual->frequencia, atual->linha, atual->coluna);
-    }
-
-    for (Adjacente* adj = atual->listaAdj; adj != NULL; adj = adj->proximo) {
-        DFS(adj->destino);
-    }
-    return true;
+    return percorrerProfundidade(atual, NULL, true);
 }
 
 
@@ -267,46 +819,51 @@ bool pontoMedioSegmentos(int x1, int y1, int x2, int y2,
 
 /**
  * @brief Executa uma busca em profundidade (DFS) a partir de uma antena.
+ * @details Iterativa, com pilha explícita: funciona para componentes de qualquer tamanho.
  * @param atual Ponteiro para a antena inicial.
- * @param visitado Array de flags para marcar as antenas já visitadas (indexado por linha*100+coluna).
+ * @param visitado Array de flags para marcar as antenas já visitadas (indexado pelo id denso, VAntena::id,
+ *                 com pelo menos numAntenas posições).
  * @return true se visitou pelo menos uma antena, false caso contrário.
  */
 bool DFS_Antena(VAntena* atual, bool* visitado) {
-    if (!atual) return false;
-    int idx = atual->linha * 100 + atual->coluna; // Supondo linhas/colunas < 100
-    if (visitado[idx]) return false; // Já visitado
-
-    visitado[idx] = true;
-    printf("Antena %c (%d,%d)\n", atual->frequencia, atual->linha, atual->coluna);
+    if (!atual || !visitado || atual->id < 0) return false;
+    if (visitado[atual->id]) return false; // Já visitado
 
-    for (Adjacente* adj = atual->listaAdj; adj != NULL; adj = adj->proximo) {
-        int proxIdx = adj->destino->linha * 100 + adj->destino->coluna;
-        if (!visitado[proxIdx]) {
-            DFS_Antena(adj->destino, visitado);
-        }
-    }
-    return true;
+    return percorrerProfundidade(atual, visitado, false);
 }
 
 /**
- * @brief Executa DFS para todas as antenas do grafo, visitando todos os componentes.
- * @param g Ponteiro para o grafo.
- * @return true se pelo menos uma antena foi visitada, false caso contrário.
+ * @brief Corpo de DFSTraversal_Antena, sem a medição de tempo (ver DFSTraversal_Antena).
  */
-bool DFSTraversal_Antena(Grafo* g) {
+static bool DFSTraversal_AntenaInterno(Grafo* g) {
     if (!g || !g->listaAntenas) return false;
-    bool visitado[10000] = {0}; // Ajusta o tamanho conforme necessário
+    bool* visitado = calloc((size_t)g->numAntenas, sizeof(bool));
+    if (!visitado) return false;
     bool algumVisitado = false;
     for (VAntena* a = g->listaAntenas; a != NULL; a = a->proximo) {
-        int idx = a->linha * 100 + a->coluna;
-        if (!visitado[idx]) {
+        if (!visitado[a->id]) {
             if (DFS_Antena(a, visitado))
                 algumVisitado = true;
         }
     }
+    free(visitado);
     return algumVisitado;
 }
 
+/**
+ * @brief Executa DFS para todas as antenas do grafo, visitando todos os componentes.
+ * @details O vetor de visitados é reservado com o número real de antenas (id denso), não com
+ *          as dimensões do mapa.
+ * @param g Ponteiro para o grafo.
+ * @return true se pelo menos uma antena foi visitada, false caso contrário.
+ */
+bool DFSTraversal_Antena(Grafo* g) {
+    METRICA_INICIO(inicio);
+    bool r = DFSTraversal_AntenaInterno(g);
+    METRICA_FIM(g, METRICA_DFS_TRAVERSAL, inicio);
+    return r;
+}
+
 /**
  * @brief Procura uma antena no grafo com frequência, linha e coluna especificadas.
  * @param g Ponteiro para o grafo.
@@ -316,10 +873,10 @@ bool DFSTraversal_Antena(Grafo* g) {
  * @return Ponteiro para a antena encontrada, ou NULL se não existir.
  */
 VAntena* procurarAntena(Grafo* g, char freq, int linha, int coluna) {
-    for (VAntena* a = g->listaAntenas; a != NULL; a = a->proximo) {
-        if (a->frequencia == freq && a->linha == linha && a->coluna == coluna)
-            return a;
-    }
+    if (!g) return NULL;
+    VAntena* a = consultarIndice(&g->indice, linha, coluna);
+    if (a && a->frequencia == freq)
+        return a;
     return NULL;
 }
 
@@ -16,6 +16,99 @@
  */
 Grafo* criarGrafo();
 
+/**
+ * @brief Esvazia o grafo, libertando todas as antenas e adjacências de uma vez.
+ * @param g Ponteiro para o grafo.
+ * @return true após esvaziar, false se o grafo for inválido.
+ */
+bool limparGrafo(Grafo* g);
+
+/**
+ * @brief Destrói o grafo, libertando toda a memória associada (incluindo o próprio grafo).
+ * @param g Ponteiro para o grafo.
+ * @return true após destruir, false se o grafo for inválido.
+ */
+bool destruirGrafo(Grafo* g);
+
+/**
+ * @brief Reserva e inicializa uma antena na arena do grafo, sem a ligar ao grafo.
+ * @param g Ponteiro para o grafo.
+ * @param freq Frequência.
+ * @param linha Linha.
+ * @param coluna Coluna.
+ * @return Ponteiro para a antena, ou NULL em caso de erro.
+ */
+VAntena* novoVertice(Grafo* g, char freq, int linha, int coluna);
+
+/**
+ * @brief Liberta uma antena já desligada do grafo.
+ * @param ant Ponteiro para a antena.
+ * @return true após libertar.
+ */
+bool libertarVertice(VAntena* ant);
+
+/**
+ * @brief Define as dimensões do mapa associado ao grafo.
+ * @param g Ponteiro para o grafo.
+ * @param linhas Número de linhas do mapa.
+ * @param colunas Número de colunas do mapa.
+ * @return true se definiu, false caso contrário.
+ */
+bool definirDimensoesGrafo(Grafo* g, int linhas, int colunas);
+
+/**
+ * @brief Define as dimensões do mapa antes de carregar um número conhecido de antenas
+ *        (o índice de posições é dimensionado para elas).
+ * @param g Ponteiro para o grafo.
+ * @param linhas Número de linhas do mapa.
+ * @param colunas Número de colunas do mapa.
+ * @param numAntenasPrevistas Número de antenas que vão ser inseridas a seguir.
+ * @return true se definiu, false caso contrário.
+ */
+bool prepararDimensoesGrafo(Grafo* g, int linhas, int colunas, int numAntenasPrevistas);
+
+/**
+ * @brief Devolve o balde com as antenas de uma frequência.
+ * @param g Ponteiro para o grafo.
+ * @param freq Frequência.
+ * @return Ponteiro para o balde, ou NULL se o grafo for inválido.
+ */
+BaldeFrequencia* baldeFrequencia(Grafo* g, char freq);
+
+/**
+ * @brief Garante que a cópia do balde ordenada por (linha, coluna) (BaldeFrequencia::porLinha) está atualizada.
+ * @param b Ponteiro para o balde.
+ * @return true se a cópia está pronta, false em caso de erro de memória.
+ */
+bool ordenarBaldePorLinha(BaldeFrequencia* b);
+
+/**
+ * @brief Liga uma antena já criada ao grafo (lista de antenas, id denso, índice de posições e balde da frequência).
+ * @details A antena deve ter sido reservada com novoVertice.
+ * @param g Ponteiro para o grafo.
+ * @param ant Ponteiro para a antena.
+ * @return true se ligou, false caso contrário.
+ */
+bool registarVertice(Grafo* g, VAntena* ant);
+
+/**
+ * @brief Liga ao grafo, de uma vez, um conjunto de antenas já criadas (com posições livres e distintas).
+ * @details As antenas ficam ligadas pela ordem dada; numAntenas só é atualizado no fim.
+ * @param g Ponteiro para o grafo.
+ * @param novas Antenas a ligar (reservadas com novoVertice).
+ * @param num Número de antenas.
+ * @return Número de antenas ligadas (as restantes devem ser libertadas), ou -1 em caso de erro.
+ */
+int registarVerticesLote(Grafo* g, VAntena** novas, int num);
+
+/**
+ * @brief Desliga uma antena do grafo (lista de antenas, id denso, índice de posições e balde da frequência), sem a libertar.
+ * @param g Ponteiro para o grafo.
+ * @param ant Ponteiro para a antena.
+ * @return true se desligou, false caso contrário.
+ */
+bool retirarVertice(Grafo* g, VAntena* ant);
+
 /**
  * @brief Imprime o grafo.
  * @param g Ponteiro para o grafo.
@@ -32,6 +125,37 @@ bool conectarAntenasMesmoTipo(Grafo* g);
 
 
 
+/**
+ * @brief Ativa ou desativa as ligações implícitas entre antenas da mesma frequência.
+ * @param g Ponteiro para o grafo.
+ * @param implicitas true para ligações implícitas (sem nós Adjacente).
+ * @return true se alterou o modo, false em caso de erro.
+ */
+bool definirArestasImplicitas(Grafo* g, bool implicitas);
+
+/**
+ * @brief Define o nível de mensagens de diagnóstico das leituras de ficheiros.
+ * @param g Ponteiro para o grafo.
+ * @param nivel 0 para nenhuma, 1 para um resumo, 2 para uma linha por antena lida.
+ * @return true se definiu, false se o grafo for inválido.
+ */
+bool definirVerbosidade(Grafo* g, int nivel);
+
+/**
+ * @brief Prepara um iterador sobre os vizinhos de uma antena (explícitos e implícitos).
+ * @param it Ponteiro para o iterador.
+ * @param origem Antena cujos vizinhos se querem percorrer.
+ * @return true se preparou, false caso contrário.
+ */
+bool iniciarVizinhos(IteradorVizinhos* it, VAntena* origem);
+
+/**
+ * @brief Devolve o próximo vizinho de um iterador.
+ * @param it Ponteiro para o iterador.
+ * @return Ponteiro para o vizinho, ou NULL quando não há mais.
+ */
+VAntena* proximoVizinho(IteradorVizinhos* it);
+
 /**
  * @brief Insere uma adjacência (ligação) entre duas antenas.
  * @param origem Ponteiro para a antena de origem.
@@ -101,16 +225,12 @@ bool imprimirDFS(Grafo* g);
  */
 bool pontoMedioSegmentos(int x1, int y1, int x2, int y2,
                          int x3, int y3, int x4, int y4,
-                         float* mx, float* my) {
-    *mx = (x1 + x2 + x3 + x4) / 4.0;
-    *my = (y1 + y2 + y3 + y4) / 4.0;
-    return true;// Retorna verdadeiro se o ponto médio foi calculado
-}
+                         float* mx, float* my);
 
 /**
  * @brief Executa uma busca em profundidade (DFS) a partir de uma antena.
  * @param atual Ponteiro para a antena inicial.
- * @param visitado Array de flags para marcar as antenas já visitadas (indexado por linha*100+coluna).
+ * @param visitado Array de flags para marcar as antenas já visitadas (indexado pelo id denso, VAntena::id).
  * @return true se visitou pelo menos uma antena, false caso contrário.
  */
 bool DFS_Antena(VAntena* atual, bool* visitado);
@@ -0,0 +1,398 @@
+#ifndef INDICE_C
+#define INDICE_C
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "Indice.h"
+/**
+ * @file Indice.c
+ * @brief Implementação do índice de posições (grelha densa + tabela de dispersão).
+ * @author João Novais
+ * @date 2025-05-18
+ *
+ */
+
+#pragma region Indice
+
+#define TABELA_CAPACIDADE_MINIMA 16
+#define ENTRADA_LIVRE 0
+#define ENTRADA_OCUPADA 1
+#define ENTRADA_REMOVIDA 2
+
+// Mapas até este número de células usam sempre grelha densa
+#define GRELHA_AREA_MINIMA (1 << 20)
+// Acima disso, só se houver pelo menos uma antena por cada N células
+#define GRELHA_CELULAS_POR_ANTENA 32
+// Maior mapa de bits aceite num conjunto de posições (128 MiB)
+#define CONJUNTO_MAXIMO_BITS (1LL << 30)
+
+/**
+ * @brief Calcula o índice inicial de uma posição na tabela.
+ * @param linha Linha.
+ * @param coluna Coluna.
+ * @param capacidade Capacidade da tabela (potência de 2).
+ * @return Índice da primeira entrada a experimentar.
+ */
+static int dispersarPosicao(int linha, int coluna, int capacidade) {
+    uint64_t k = ((uint64_t)(uint32_t)linha << 32) | (uint32_t)coluna;
+    k *= 0x9E3779B97F4A7C15ULL;
+    k ^= k >> 29;
+    return (int)(k & (uint64_t)(capacidade - 1));
+}
+
+/**
+ * @brief Inicializa uma tabela de dispersão de posições vazia.
+ * @param t Ponteiro para a tabela.
+ * @return true se inicializou, false caso contrário.
+ */
+bool iniciarTabelaPosicoes(TabelaPosicoes* t) {
+    if (!t) return false;
+    t->entradas = NULL; // Só reserva memória na primeira inserção
+    t->capacidade = 0;
+    t->ocupadas = 0;
+    t->removidas = 0;
+    return true;
+}
+
+/**
+ * @brief Procura a entrada de uma posição (ocupada) na tabela.
+ * @param t Ponteiro para a tabela.
+ * @param linha Linha.
+ * @param coluna Coluna.
+ * @return Ponteiro para a entrada, ou NULL se não existir.
+ */
+static EntradaPosicao* procurarEntrada(const TabelaPosicoes* t, int linha, int coluna) {
+    if (!t || t->capacidade == 0) return NULL;
+    int i = dispersarPosicao(linha, coluna, t->capacidade);
+    while (t->entradas[i].estado != ENTRADA_LIVRE) {
+        EntradaPosicao* e = &t->entradas[i];
+        if (e->estado == ENTRADA_OCUPADA && e->linha == linha && e->coluna == coluna)
+            return e;
+        i = (i + 1) & (t->capacidade - 1);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Reconstrói a tabela com uma nova capacidade (elimina lápides).
+ * @param t Ponteiro para a tabela.
+ * @param capacidade Nova capacidade (potência de 2).
+ * @return true se reconstruiu, false em caso de erro de memória.
+ */
+static bool redimensionarTabela(TabelaPosicoes* t, int capacidade) {
+    EntradaPosicao* novas = calloc((size_t)capacidade, sizeof(EntradaPosicao));
+    if (!novas) return false;
+
+    for (int j = 0; j < t->capacidade; j++) {
+        EntradaPosicao* e = &t->entradas[j];
+        if (e->estado != ENTRADA_OCUPADA) continue;
+        int i = dispersarPosicao(e->linha, e->coluna, capacidade);
+        while (novas[i].estado != ENTRADA_LIVRE) i = (i + 1) & (capacidade - 1);
+        novas[i] = *e;
+    }
+    free(t->entradas);
+    t->entradas = novas;
+    t->capacidade = capacidade;
+    t->removidas = 0;
+    return true;
+}
+
+/**
+ * @brief Procura o valor associado a uma posição.
+ * @param t Ponteiro para a tabela.
+ * @param linha Linha.
+ * @param coluna Coluna.
+ * @return Valor associado, ou NULL se a posição não existir.
+ */
+void* procurarTabelaPosicoes(const TabelaPosicoes* t, int linha, int coluna) {
+    EntradaPosicao* e = procurarEntrada(t, linha, coluna);
+    return e ? e->valor : NULL;
+}
+
+/**
+ * @brief Associa um valor a uma posição (substitui se já existir).
+ * @param t Ponteiro para a tabela.
+ * @param linha Linha.
+ * @param coluna Coluna.
+ * @param valor Valor a guardar (não pode ser NULL).
+ * @return true se guardou, false em caso de erro de memória.
+ */
+bool inserirTabelaPosicoes(TabelaPosicoes* t, int linha, int coluna, void* valor) {
+    if (!t || !valor) return false;
+
+    EntradaPosicao* existente = procurarEntrada(t, linha, coluna);
+    if (existente) {
+        existente->valor = valor;
+        return true;
+    }
+    // Mantém a ocupação (incluindo lápides) abaixo de metade
+    if ((t->ocupadas + t->removidas + 1) * 2 > t->capacidade) {
+        int capacidade = TABELA_CAPACIDADE_MINIMA;
+        while (capacidade < (t->ocupadas + 1) * 4) capacidade *= 2;
+        if (!redimensionarTabela(t, capacidade)) return false;
+    }
+    int i = dispersarPosicao(linha, coluna, t->capacidade);
+    while (t->entradas[i].estado == ENTRADA_OCUPADA) i = (i + 1) & (t->capacidade - 1);
+    if (t->entradas[i].estado == ENTRADA_REMOVIDA) t->removidas--;
+    t->entradas[i].linha = linha;
+    t->entradas[i].coluna = coluna;
+    t->entradas[i].estado = ENTRADA_OCUPADA;
+    t->entradas[i].valor = valor;
+    t->ocupadas++;
+    return true;
+}
+
+/**
+ * @brief Remove uma posição da tabela.
+ * @param t Ponteiro para a tabela.
+ * @param linha Linha.
+ * @param coluna Coluna.
+ * @return true se removeu, false se não existia.
+ */
+bool removerTabelaPosicoes(TabelaPosicoes* t, int linha, int coluna) {
+    EntradaPosicao* e = procurarEntrada(t, linha, coluna);
+    if (!e) return false;
+    e->estado = ENTRADA_REMOVIDA; // Lápide para não quebrar as sequências de sondagem
+    e->valor = NULL;
+    t->ocupadas--;
+    t->removidas++;
+    return true;
+}
+
+/**
+ * @brief Devolve a próxima entrada ocupada da tabela, para percorrer todas as posições.
+ * @param t Ponteiro para a tabela.
+ * @param posicao Posição de onde continuar (começar em 0); é avançada para depois da entrada devolvida.
+ * @return Ponteiro para a entrada, ou NULL quando não há mais.
+ */
+EntradaPosicao* proximaEntradaTabela(const TabelaPosicoes* t, int* posicao) {
+    if (!t || !posicao) return NULL;
+    while (*posicao < t->capacidade) {
+        EntradaPosicao* e = &t->entradas[(*posicao)++];
+        if (e->estado == ENTRADA_OCUPADA) return e;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Liberta a memória da tabela.
+ * @param t Ponteiro para a tabela.
+ * @return true após libertar.
+ */
+bool libertarTabelaPosicoes(TabelaPosicoes* t) {
+    if (!t) return false;
+    free(t->entradas);
+    return iniciarTabelaPosicoes(t);
+}
+
+/**
+ * @brief Inicializa um índice de posições sem limites (só tabela de dispersão).
+ * @param idx Ponteiro para o índice.
+ * @return true se inicializou, false caso contrário.
+ */
+bool iniciarIndice(IndicePosicoes* idx) {
+    if (!idx) return false;
+    idx->linhas = 0;
+    idx->colunas = 0;
+    idx->grelha = NULL;
+    return iniciarTabelaPosicoes(&idx->tabela);
+}
+
+/**
+ * @brief Verifica se uma posição cai dentro da grelha densa.
+ * @param idx Ponteiro para o índice.
+ * @param linha Linha.
+ * @param coluna Coluna.
+ * @return true se a posição é guardada na grelha, false se vai para a tabela.
+ */
+static bool dentroGrelha(const IndicePosicoes* idx, int linha, int coluna) {
+    return idx->grelha && linha >= 0 && coluna >= 0 &&
+           linha < idx->linhas && coluna < idx->colunas;
+}
+
+/**
+ * @brief Define os limites do mapa e, se compensar, passa a usar uma grelha densa.
+ * @details A grelha só é usada quando o mapa é pequeno ou suficientemente denso;
+ *          mapas grandes e esparsos continuam apenas na tabela de dispersão.
+ * @param idx Ponteiro para o índice.
+ * @param linhas Número de linhas do mapa.
+ * @param colunas Número de colunas do mapa.
+ * @param numAntenas Número de antenas esperado (decide entre grelha e tabela).
+ * @return true se definiu, false em caso de erro de memória.
+ */
+bool definirLimitesIndice(IndicePosicoes* idx, int linhas, int colunas, int numAntenas) {
+    if (!idx || linhas < 0 || colunas < 0) return false;
+
+    long long area = (long long)linhas * colunas;
+    bool usarGrelha = area > 0 && (area <= GRELHA_AREA_MINIMA ||
+                                   area <= (long long)numAntenas * GRELHA_CELULAS_POR_ANTENA);
+
+    IndicePosicoes novo;
+    iniciarIndice(&novo);
+    if (usarGrelha) {
+        novo.grelha = calloc((size_t)area, sizeof(VAntena*));
+        if (!novo.grelha) return false;
+        novo.linhas = linhas;
+        novo.colunas = colunas;
+    }
+
+    // Passa todas as antenas do índice antigo para o novo
+    bool ok = true;
+    if (idx->grelha) {
+        long long areaAntiga = (long long)idx->linhas * idx->colunas;
+        for (long long i = 0; i < areaAntiga && ok; i++) {
+            if (idx->grelha[i]) ok = registarIndice(&novo, idx->grelha[i]);
+        }
+    }
+    for (int i = 0; i < idx->tabela.capacidade && ok; i++) {
+        if (idx->tabela.entradas[i].estado == ENTRADA_OCUPADA)
+            ok = registarIndice(&novo, (VAntena*)idx->tabela.entradas[i].valor);
+    }
+    if (!ok) {
+        libertarIndice(&novo);
+        return false;
+    }
+    libertarIndice(idx);
+    *idx = novo;
+    return true;
+}
+
+/**
+ * @brief Devolve a antena guardada numa posição.
+ * @param idx Ponteiro para o índice.
+ * @param linha Linha.
+ * @param coluna Coluna.
+ * @return Ponteiro para a antena, ou NULL se a posição estiver livre.
+ */
+VAntena* consultarIndice(const IndicePosicoes* idx, int linha, int coluna) {
+    if (!idx) return NULL;
+    if (dentroGrelha(idx, linha, coluna))
+        return idx->grelha[(size_t)linha * idx->colunas + coluna];
+    return (VAntena*)procurarTabelaPosicoes(&idx->tabela, linha, coluna);
+}
+
+/**
+ * @brief Regista uma antena no índice, na sua posição.
+ * @param idx Ponteiro para o índice.
+ * @param ant Ponteiro para a antena.
+ * @return true se registou, false em caso de erro de memória.
+ */
+bool registarIndice(IndicePosicoes* idx, VAntena* ant) {
+    if (!idx || !ant) return false;
+    if (dentroGrelha(idx, ant->linha, ant->coluna)) {
+        idx->grelha[(size_t)ant->linha * idx->colunas + ant->coluna] = ant;
+        return true;
+    }
+    return inserirTabelaPosicoes(&idx->tabela, ant->linha, ant->coluna, ant);
+}
+
+/**
+ * @brief Retira uma posição do índice.
+ * @param idx Ponteiro para o índice.
+ * @param linha Linha.
+ * @param coluna Coluna.
+ * @return true se retirou, false se a posição estava livre.
+ */
+bool retirarIndice(IndicePosicoes* idx, int linha, int coluna) {
+    if (!idx) return false;
+    if (dentroGrelha(idx, linha, coluna)) {
+        VAntena** celula = &idx->grelha[(size_t)linha * idx->colunas + coluna];
+        if (!*celula) return false;
+        *celula = NULL;
+        return true;
+    }
+    return removerTabelaPosicoes(&idx->tabela, linha, coluna);
+}
+
+/**
+ * @brief Liberta a memória do índice.
+ * @param idx Ponteiro para o índice.
+ * @return true após libertar.
+ */
+bool libertarIndice(IndicePosicoes* idx) {
+    if (!idx) return false;
+    free(idx->grelha);
+    libertarTabelaPosicoes(&idx->tabela);
+    return iniciarIndice(idx);
+}
+
+/**
+ * @brief Inicializa um conjunto de posições vazio.
+ * @param c Ponteiro para o conjunto.
+ * @param linhas Número de linhas do mapa (0 se desconhecido).
+ * @param colunas Número de colunas do mapa (0 se desconhecido).
+ * @return true se inicializou, false em caso de erro de memória.
+ */
+bool iniciarConjuntoPosicoes(ConjuntoPosicoes* c, int linhas, int colunas) {
+    if (!c) return false;
+    c->linhas = 0;
+    c->colunas = 0;
+    c->bits = NULL;
+    c->numPosicoes = 0;
+    iniciarTabelaPosicoes(&c->fora);
+
+    long long area = (long long)linhas * colunas;
+    if (linhas > 0 && colunas > 0 && area <= CONJUNTO_MAXIMO_BITS) {
+        c->bits = calloc((size_t)((area + 7) / 8), 1);
+        if (!c->bits) return false;
+        c->linhas = linhas;
+        c->colunas = colunas;
+    }
+    return true;
+}
+
+/**
+ * @brief Acrescenta uma posição ao conjunto.
+ * @param c Ponteiro para o conjunto.
+ * @param linha Linha.
+ * @param coluna Coluna.
+ * @return true se a posição é nova, false se já existia (ou erro de memória).
+ */
+bool adicionarConjuntoPosicoes(ConjuntoPosicoes* c, int linha, int coluna) {
+    if (!c) return false;
+    if (c->bits && linha >= 0 && coluna >= 0 && linha < c->linhas && coluna < c->colunas) {
+        size_t bit = (size_t)linha * c->colunas + coluna;
+        unsigned char mascara = (unsigned char)(1u << (bit & 7));
+        if (c->bits[bit >> 3] & mascara) return false;
+        c->bits[bit >> 3] |= mascara;
+        c->numPosicoes++;
+        return true;
+    }
+    if (procurarTabelaPosicoes(&c->fora, linha, coluna)) return false;
+    if (!inserirTabelaPosicoes(&c->fora, linha, coluna, c)) return false;
+    c->numPosicoes++;
+    return true;
+}
+
+/**
+ * @brief Verifica se uma posição pertence ao conjunto.
+ * @param c Ponteiro para o conjunto.
+ * @param linha Linha.
+ * @param coluna Coluna.
+ * @return true se pertence, false caso contrário.
+ */
+bool pertenceConjuntoPosicoes(const ConjuntoPosicoes* c, int linha, int coluna) {
+    if (!c) return false;
+    if (c->bits && linha >= 0 && coluna >= 0 && linha < c->linhas && coluna < c->colunas) {
+        size_t bit = (size_t)linha * c->colunas + coluna;
+        return (c->bits[bit >> 3] >> (bit & 7)) & 1;
+    }
+    return procurarTabelaPosicoes(&c->fora, linha, coluna) != NULL;
+}
+
+/**
+ * @brief Liberta a memória do conjunto.
+ * @param c Ponteiro para o conjunto.
+ * @return true após libertar.
+ */
+bool libertarConjuntoPosicoes(ConjuntoPosicoes* c) {
+    if (!c) return false;
+    free(c->bits);
+    libertarTabelaPosicoes(&c->fora);
+    return iniciarConjuntoPosicoes(c, 0, 0);
+}
+
+#pragma endregion
+#endif
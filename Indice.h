@@ -0,0 +1,148 @@
+#ifndef INDICE_H
+#define INDICE_H
+
+#include <stdbool.h>
+#include "Dados.h"
+
+/**
+ * @file Indice.h
+ * @brief Índice de posições (linha, coluna) para consultas em tempo constante.
+ * @author João Novais
+ * @date 2025-05-18
+ */
+
+/**
+ * @brief Inicializa uma tabela de dispersão de posições vazia.
+ * @param t Ponteiro para a tabela.
+ * @return true se inicializou, false caso contrário.
+ */
+bool iniciarTabelaPosicoes(TabelaPosicoes* t);
+
+/**
+ * @brief Procura o valor associado a uma posição.
+ * @param t Ponteiro para a tabela.
+ * @param linha Linha.
+ * @param coluna Coluna.
+ * @return Valor associado, ou NULL se a posição não existir.
+ */
+void* procurarTabelaPosicoes(const TabelaPosicoes* t, int linha, int coluna);
+
+/**
+ * @brief Associa um valor a uma posição (substitui se já existir).
+ * @param t Ponteiro para a tabela.
+ * @param linha Linha.
+ * @param coluna Coluna.
+ * @param valor Valor a guardar (não pode ser NULL).
+ * @return true se guardou, false em caso de erro de memória.
+ */
+bool inserirTabelaPosicoes(TabelaPosicoes* t, int linha, int coluna, void* valor);
+
+/**
+ * @brief Remove uma posição da tabela.
+ * @param t Ponteiro para a tabela.
+ * @param linha Linha.
+ * @param coluna Coluna.
+ * @return true se removeu, false se não existia.
+ */
+bool removerTabelaPosicoes(TabelaPosicoes* t, int linha, int coluna);
+
+/**
+ * @brief Devolve a próxima entrada ocupada da tabela, para percorrer todas as posições.
+ * @param t Ponteiro para a tabela.
+ * @param posicao Posição de onde continuar (começar em 0); é avançada para depois da entrada devolvida.
+ * @return Ponteiro para a entrada, ou NULL quando não há mais.
+ */
+EntradaPosicao* proximaEntradaTabela(const TabelaPosicoes* t, int* posicao);
+
+/**
+ * @brief Liberta a memória da tabela.
+ * @param t Ponteiro para a tabela.
+ * @return true após libertar.
+ */
+bool libertarTabelaPosicoes(TabelaPosicoes* t);
+
+/**
+ * @brief Inicializa um índice de posições sem limites (só tabela de dispersão).
+ * @param idx Ponteiro para o índice.
+ * @return true se inicializou, false caso contrário.
+ */
+bool iniciarIndice(IndicePosicoes* idx);
+
+/**
+ * @brief Define os limites do mapa e, se compensar, passa a usar uma grelha densa.
+ * @param idx Ponteiro para o índice.
+ * @param linhas Número de linhas do mapa.
+ * @param colunas Número de colunas do mapa.
+ * @param numAntenas Número de antenas esperado (decide entre grelha e tabela).
+ * @return true se definiu, false em caso de erro de memória.
+ */
+bool definirLimitesIndice(IndicePosicoes* idx, int linhas, int colunas, int numAntenas);
+
+/**
+ * @brief Devolve a antena guardada numa posição.
+ * @param idx Ponteiro para o índice.
+ * @param linha Linha.
+ * @param coluna Coluna.
+ * @return Ponteiro para a antena, ou NULL se a posição estiver livre.
+ */
+VAntena* consultarIndice(const IndicePosicoes* idx, int linha, int coluna);
+
+/**
+ * @brief Regista uma antena no índice, na sua posição.
+ * @param idx Ponteiro para o índice.
+ * @param ant Ponteiro para a antena.
+ * @return true se registou, false em caso de erro de memória.
+ */
+bool registarIndice(IndicePosicoes* idx, VAntena* ant);
+
+/**
+ * @brief Retira uma posição do índice.
+ * @param idx Ponteiro para o índice.
+ * @param linha Linha.
+ * @param coluna Coluna.
+ * @return true se retirou, false se a posição estava livre.
+ */
+bool retirarIndice(IndicePosicoes* idx, int linha, int coluna);
+
+/**
+ * @brief Liberta a memória do índice.
+ * @param idx Ponteiro para o índice.
+ * @return true após libertar.
+ */
+bool libertarIndice(IndicePosicoes* idx);
+
+/**
+ * @brief Inicializa um conjunto de posições vazio.
+ * @param c Ponteiro para o conjunto.
+ * @param linhas Número de linhas do mapa (0 se desconhecido).
+ * @param colunas Número de colunas do mapa (0 se desconhecido).
+ * @return true se inicializou, false em caso de erro de memória.
+ */
+bool iniciarConjuntoPosicoes(ConjuntoPosicoes* c, int linhas, int colunas);
+
+/**
+ * @brief Acrescenta uma posição ao conjunto.
+ * @param c Ponteiro para o conjunto.
+ * @param linha Linha.
+ * @param coluna Coluna.
+ * @return true se a posição é nova, false se já existia (ou erro de memória).
+ */
+bool adicionarConjuntoPosicoes(ConjuntoPosicoes* c, int linha, int coluna);
+
+/**
+ * @brief Verifica se uma posição pertence ao conjunto.
+ * @param c Ponteiro para o conjunto.
+ * @param linha Linha.
+ * @param coluna Coluna.
+ * @return true se pertence, false caso contrário.
+ */
+bool pertenceConjuntoPosicoes(const ConjuntoPosicoes* c, int linha, int coluna);
+
+/**
+ * @brief Liberta a memória do conjunto.
+ * @param c Ponteiro para o conjunto.
+ * @return true após libertar.
+ */
+bool libertarConjuntoPosicoes(ConjuntoPosicoes* c);
+
+#endif
@@ -0,0 +1,265 @@
+#ifndef LOTE_C
+#define LOTE_C
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <pthread.h>
+#include "Grafo.h"
+#include "Nefasto.h"
+#include "Ficheiros.h"
+#include "Memoria.h"
+#include "Metricas.h"
+#include "Lote.h"
+/**
+ * @file Lote.c
+ * @brief Implementação do processamento em lote com um conjunto de threads e roubo de trabalho.
+ * @author João Novais
+ * @date 2025-05-18
+ *
+ */
+
+#pragma region Lote
+
+/**
+ * @brief Fila de tarefas de uma thread: índices [inicio, fim) do lote.
+ * @details A dona tira do início; as outras threads roubam metade do fim.
+ */
+typedef struct FilaLote {
+    int inicio, fim;
+    pthread_mutex_t trinco;
+} FilaLote;
+
+/**
+ * @brief Estado de cada thread de trabalho.
+ */
+typedef struct TrabalhadorLote {
+    int indice;
+    FilaLote* filas;
+    int numFilas;
+    const TarefaLote* tarefas;
+    ResultadoLote* resultados;
+} TrabalhadorLote;
+
+// Nomes das etapas, pela ordem de EtapaLote
+static const char* nomesEtapas[] = {
+    "concluida",
+    "grafo",
+    "leitura",
+    "mapa",
+    "binario"
+};
+
+/**
+ * @brief Executa uma tarefa do lote com um grafo próprio (leitura, efeitos e escrita das saídas).
+ * @param tarefa Ficheiros da tarefa.
+ * @param resultado Resultado a preencher.
+ * @param trabalhador Índice da thread que executa a tarefa.
+ */
+static void executarTarefaLote(const TarefaLote* tarefa, ResultadoLote* resultado, int trabalhador) {
+    double inicio = relogioMetricas();
+    resultado->linhas = resultado->colunas = 0;
+    resultado->numAntenas = resultado->numEfeitos = 0;
+    resultado->trabalhador = trabalhador;
+
+    Grafo* g = criarGrafo();
+    if (!g) {
+        resultado->etapa = LOTE_ERRO_GRAFO;
+        resultado->segundos = relogioMetricas() - inicio;
+        return;
+    }
+
+    ResultadoEfeitos efeitos;
+    efeitos.lista = NULL;
+    efeitos.numEfeitos = 0;
+    iniciarArena(&efeitos.arena, sizeof(EfeitoNefasto));
+    EtapaLote etapa = LOTE_CONCLUIDA;
+    int linhas = 0, colunas = 0;
+    if (!tarefa->entrada || !lerMatrizAntenas(g, tarefa->entrada, &linhas, &colunas)) {
+        etapa = LOTE_ERRO_LEITURA;
+    } else {
+        calcularResultadoEfeitos(g, &efeitos); // false só indica que não há efeitos
+        if (tarefa->saidaMapa && !escreverMapaComEfeitos(tarefa->saidaMapa, g, efeitos.lista, linhas, colunas))
+            etapa = LOTE_ERRO_MAPA;
+        else if (tarefa->saidaBinario && !guardarBinario(tarefa->saidaBinario, g))
+            etapa = LOTE_ERRO_BINARIO;
+    }
+
+    resultado->etapa = etapa;
+    resultado->linhas = linhas;
+    resultado->colunas = colunas;
+    resultado->numAntenas = g->numAntenas;
+    resultado->numEfeitos = efeitos.numEfeitos;
+    libertarEfeitos(&efeitos);
+    destruirGrafo(g);
+    resultado->segundos = relogioMetricas() - inicio;
+}
+
+/**
+ * @brief Tira a próxima tarefa da fila da própria thread.
+ * @param f Fila.
+ * @param tarefa Ponteiro onde guardar o índice da tarefa.
+ * @return true se havia tarefa, false se a fila está vazia.
+ */
+static bool tirarTarefaLote(FilaLote* f, int* tarefa) {
+    bool ha = false;
+    pthread_mutex_lock(&f->trinco);
+    if (f->inicio < f->fim) {
+        *tarefa = f->inicio++;
+        ha = true;
+    }
+    pthread_mutex_unlock(&f->trinco);
+    return ha;
+}
+
+/**
+ * @brief Rouba metade das tarefas pendentes de outra thread (a primeira que tiver alguma).
+ * @details A primeira tarefa roubada é devolvida para execução imediata; as restantes passam para a fila da
+ *          própria thread (que está vazia), onde podem voltar a ser roubadas.
+ * @param t Estado da thread que rouba.
+ * @param tarefa Ponteiro onde guardar o índice da tarefa.
+ * @return true se roubou, false se todas as filas estão vazias.
+ */
+static bool roubarTarefaLote(TrabalhadorLote* t, int* tarefa) {
+    for (int k = 1; k < t->numFilas; k++) {
+        FilaLote* vitima = &t->filas[(t->indice + k) % t->numFilas];
+        int de = 0, ate = 0;
+        pthread_mutex_lock(&vitima->trinco);
+        int pendentes = vitima->fim - vitima->inicio;
+        if (pendentes > 0) {
+            de = vitima->fim - (pendentes + 1) / 2;
+            ate = vitima->fim;
+            vitima->fim = de;
+        }
+        pthread_mutex_unlock(&vitima->trinco);
+        if (ate == de) continue;
+
+        FilaLote* propria = &t->filas[t->indice];
+        pthread_mutex_lock(&propria->trinco);
+        propria->inicio = de + 1;
+        propria->fim = ate;
+        pthread_mutex_unlock(&propria->trinco);
+        *tarefa = de;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Corpo de cada thread: esgota a sua fila e depois rouba das outras até não haver trabalho.
+ * @param arg Ponteiro para TrabalhadorLote.
+ * @return NULL.
+ */
+static void* trabalharLote(void* arg) {
+    TrabalhadorLote* t = (TrabalhadorLote*)arg;
+    int tarefa;
+    while (tirarTarefaLote(&t->filas[t->indice], &tarefa) || roubarTarefaLote(t, &tarefa)) {
+        executarTarefaLote(&t->tarefas[tarefa], &t->resultados[tarefa], t->indice);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Processa um lote de mapas: lê cada entrada, calcula os efeitos nefastos e escreve as saídas pedidas.
+ * @details As tarefas começam repartidas em blocos contíguos, um por thread; quando uma thread esvazia o seu,
+ *          rouba metade do que resta a outra (os ficheiros podem ter tamanhos muito diferentes). A thread que
+ *          chama é a thread 0; se não for possível criar alguma das outras, a sua fila acaba roubada pelas
+ *          restantes. Cada tarefa usa um grafo próprio (com verbosidade 0), pelo que não há estado partilhado
+ *          entre tarefas nem escrita no stdout.
+ * @param tarefas Ficheiros de cada tarefa.
+ * @param num Número de tarefas.
+ * @param numThreads Número de threads de trabalho.
+ * @param resultados Vetor com num resultados a preencher (tempo e etapa em que falhou, por tarefa).
+ * @return Número de tarefas concluídas sem erro, ou -1 se os argumentos forem inválidos.
+ */
+int processarLote(const TarefaLote* tarefas, int num, int numThreads, ResultadoLote* resultados) {
+    if (num < 0 || (num > 0 && (!tarefas || !resultados))) return -1;
+    if (numThreads > num) numThreads = num;
+    if (numThreads < 1) numThreads = 1;
+
+    FilaLote* filas = NULL;
+    TrabalhadorLote* trabalhadores = NULL;
+    pthread_t* threads = NULL;
+    if (numThreads > 1) {
+        filas = malloc((size_t)numThreads * sizeof(FilaLote));
+        trabalhadores = malloc((size_t)numThreads * sizeof(TrabalhadorLote));
+        threads = malloc((size_t)numThreads * sizeof(pthread_t));
+        if (!filas || !trabalhadores || !threads) {
+            free(filas);
+            free(trabalhadores);
+            free(threads);
+            numThreads = 1;
+        }
+    }
+
+    if (numThreads <= 1) {
+        for (int i = 0; i < num; i++) executarTarefaLote(&tarefas[i], &resultados[i], 0);
+    } else {
+        for (int i = 0; i < numThreads; i++) {
+            filas[i].inicio = (int)((long long)num * i / numThreads);
+            filas[i].fim = (int)((long long)num * (i + 1) / numThreads);
+            pthread_mutex_init(&filas[i].trinco, NULL);
+            trabalhadores[i].indice = i;
+            trabalhadores[i].filas = filas;
+            trabalhadores[i].numFilas = numThreads;
+            trabalhadores[i].tarefas = tarefas;
+            trabalhadores[i].resultados = resultados;
+        }
+        bool* criada = calloc((size_t)numThreads, sizeof(bool));
+        for (int i = 1; i < numThreads && criada; i++)
+            criada[i] = pthread_create(&threads[i], NULL, trabalharLote, &trabalhadores[i]) == 0;
+        trabalharLote(&trabalhadores[0]);
+        for (int i = 1; i < numThreads && criada; i++)
+            if (criada[i]) pthread_join(threads[i], NULL);
+        for (int i = 0; i < numThreads; i++) pthread_mutex_destroy(&filas[i].trinco);
+        free(criada);
+        free(filas);
+        free(trabalhadores);
+        free(threads);
+    }
+
+    int concluidas = 0;
+    for (int i = 0; i < num; i++) concluidas += resultados[i].etapa == LOTE_CONCLUIDA;
+    return concluidas;
+}
+
+/**
+ * @brief Devolve o nome de uma etapa do processamento em lote.
+ * @param etapa Etapa.
+ * @return Nome da etapa, ou NULL se for inválida.
+ */
+const char* nomeEtapaLote(EtapaLote etapa) {
+    if (etapa < LOTE_CONCLUIDA || etapa > LOTE_ERRO_BINARIO) return NULL;
+    return nomesEtapas[etapa];
+}
+
+/**
+ * @brief Escreve um relatório CSV do lote (uma linha por ficheiro, com tempo e etapa em que falhou).
+ * @details Colunas: entrada,etapa,linhas,colunas,antenas,efeitos,segundos,thread.
+ * @param filename Nome do ficheiro a escrever.
+ * @param tarefas Ficheiros de cada tarefa.
+ * @param resultados Resultados de processarLote.
+ * @param num Número de tarefas.
+ * @return true se escreveu, false caso contrário.
+ */
+bool escreverRelatorioLote(const char* filename, const TarefaLote* tarefas, const ResultadoLote* resultados, int num) {
+    if (!filename || num < 0 || (num > 0 && (!tarefas || !resultados))) return false;
+    FILE* f = fopen(filename, "w");
+    if (!f) return false;
+
+    fprintf(f, "entrada,etapa,linhas,colunas,antenas,efeitos,segundos,thread\n");
+    for (int i = 0; i < num; i++) {
+        const ResultadoLote* r = &resultados[i];
+        const char* etapa = nomeEtapaLote(r->etapa);
+        fprintf(f, "%s,%s,%d,%d,%d,%d,%.6f,%d\n", tarefas[i].entrada ? tarefas[i].entrada : "",
+                etapa ? etapa : "?", r->linhas, r->colunas, r->numAntenas, r->numEfeitos, r->segundos, r->trabalhador);
+    }
+
+    bool ok = !ferror(f);
+    if (fclose(f) != 0) ok = false;
+    return ok;
+}
+
+#pragma endregion
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef LOTE_H
+#define LOTE_H
+
+#include <stdbool.h>
+#include "Dados.h"
+
+/**
+ * @file Lote.h
+ * @brief Processamento em lote de muitos mapas, em paralelo (um grafo privado por ficheiro).
+ * @author João Novais
+ * @date 2025-05-18
+ */
+
+/**
+ * @brief Processa um lote de mapas: lê cada entrada, calcula os efeitos nefastos e escreve as saídas pedidas.
+ * @details As tarefas são repartidas por numThreads threads com roubo de trabalho; cada tarefa usa um grafo
+ *          próprio, sem estado partilhado nem escrita no stdout. Com numThreads <= 1 corre na thread que chama.
+ * @param tarefas Ficheiros de cada tarefa.
+ * @param num Número de tarefas.
+ * @param numThreads Número de threads de trabalho.
+ * @param resultados Vetor com num resultados a preencher (tempo e etapa em que falhou, por tarefa).
+ * @return Número de tarefas concluídas sem erro, ou -1 se os argumentos forem inválidos.
+ */
+int processarLote(const TarefaLote* tarefas, int num, int numThreads, ResultadoLote* resultados);
+
+/**
+ * @brief Devolve o nome de uma etapa do processamento em lote.
+ * @param etapa Etapa.
+ * @return Nome da etapa, ou NULL se for inválida.
+ */
+const char* nomeEtapaLote(EtapaLote etapa);
+
+/**
+ * @brief Escreve um relatório CSV do lote (uma linha por ficheiro, com tempo e etapa em que falhou).
+ * @param filename Nome do ficheiro a escrever.
+ * @param tarefas Ficheiros de cada tarefa.
+ * @param resultados Resultados de processarLote.
+ * @param num Número de tarefas.
+ * @return true se escreveu, false caso contrário.
+ */
+bool escreverRelatorioLote(const char* filename, const TarefaLote* tarefas, const ResultadoLote* resultados, int num);
+
+#endif
@@ -0,0 +1,122 @@
+#ifndef MEMORIA_C
+#define MEMORIA_C
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "Memoria.h"
+/**
+ * @file Memoria.c
+ * @brief Implementação das arenas de objetos de tamanho fixo.
+ * @author João Novais
+ * @date 2025-05-18
+ *
+ */
+
+#pragma region Memoria
+
+// O primeiro bloco tem este número de objetos; cada bloco novo dobra, até ao máximo
+#define ARENA_OBJETOS_INICIAIS 64
+#define ARENA_OBJETOS_MAXIMOS 65536
+
+/**
+ * @brief Cabeçalho de cada bloco de memória da arena (os objetos vêm a seguir).
+ */
+typedef struct BlocoArena {
+    struct BlocoArena* proximo;
+} BlocoArena;
+
+/**
+ * @brief Nó da lista de objetos livres (sobrepõe-se ao objeto devolvido).
+ */
+typedef struct ObjetoLivre {
+    struct ObjetoLivre* proximo;
+} ObjetoLivre;
+
+/**
+ * @brief Inicializa uma arena vazia.
+ * @param a Ponteiro para a arena.
+ * @param tamanhoObjeto Tamanho de cada objeto, em bytes.
+ * @return true se inicializou, false caso contrário.
+ */
+bool iniciarArena(Arena* a, size_t tamanhoObjeto) {
+    if (!a || tamanhoObjeto == 0) return false;
+    // Cada objeto tem de conseguir guardar o ponteiro da lista de livres e manter o alinhamento
+    size_t alinhamento = sizeof(void*) > sizeof(double) ? sizeof(void*) : sizeof(double);
+    if (tamanhoObjeto < sizeof(ObjetoLivre)) tamanhoObjeto = sizeof(ObjetoLivre);
+    a->tamanhoObjeto = (tamanhoObjeto + alinhamento - 1) / alinhamento * alinhamento;
+    a->blocos = NULL;
+    a->livres = NULL;
+    a->seguinte = NULL;
+    a->restantes = 0;
+    a->objetosPorBloco = ARENA_OBJETOS_INICIAIS;
+    a->numObjetos = 0;
+    return true;
+}
+
+/**
+ * @brief Reserva um objeto da arena (reutiliza objetos devolvidos, se houver).
+ * @param a Ponteiro para a arena.
+ * @return Ponteiro para o objeto (não inicializado), ou NULL em caso de erro de memória.
+ */
+void* reservarArena(Arena* a) {
+    if (!a) return NULL;
+
+    if (a->livres) {
+        ObjetoLivre* obj = (ObjetoLivre*)a->livres;
+        a->livres = obj->proximo;
+        a->numObjetos++;
+        return obj;
+    }
+    if (a->restantes == 0) {
+        // Cabeçalho arredondado ao tamanho do objeto para manter o alinhamento
+        size_t cabecalho = (sizeof(BlocoArena) + a->tamanhoObjeto - 1) / a->tamanhoObjeto * a->tamanhoObjeto;
+        BlocoArena* bloco = malloc(cabecalho + a->tamanhoObjeto * (size_t)a->objetosPorBloco);
+        if (!bloco) return NULL;
+        bloco->proximo = a->blocos;
+        a->blocos = bloco;
+        a->seguinte = (char*)bloco + cabecalho;
+        a->restantes = a->objetosPorBloco;
+        if (a->objetosPorBloco < ARENA_OBJETOS_MAXIMOS) a->objetosPorBloco *= 2;
+    }
+    void* obj = a->seguinte;
+    a->seguinte += a->tamanhoObjeto;
+    a->restantes--;
+    a->numObjetos++;
+    return obj;
+}
+
+/**
+ * @brief Devolve um objeto à lista de livres da arena, para ser reutilizado.
+ * @param a Ponteiro para a arena.
+ * @param obj Objeto reservado desta arena.
+ * @return true se devolveu, false caso contrário.
+ */
+bool devolverArena(Arena* a, void* obj) {
+    if (!a || !obj) return false;
+    ObjetoLivre* livre = (ObjetoLivre*)obj;
+    livre->proximo = (ObjetoLivre*)a->livres;
+    a->livres = livre;
+    a->numObjetos--;
+    return true;
+}
+
+/**
+ * @brief Liberta de uma vez todos os blocos da arena (todos os objetos deixam de ser válidos).
+ * @details O custo é proporcional ao número de blocos, não ao número de objetos.
+ * @param a Ponteiro para a arena.
+ * @return true após libertar.
+ */
+bool libertarArena(Arena* a) {
+    if (!a) return false;
+    BlocoArena* bloco = (BlocoArena*)a->blocos;
+    while (bloco) {
+        BlocoArena* temp = bloco;
+        bloco = bloco->proximo;
+        free(temp);
+    }
+    return iniciarArena(a, a->tamanhoObjeto);
+}
+
+#pragma endregion
+#endif
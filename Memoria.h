@@ -0,0 +1,45 @@
+#ifndef MEMORIA_H
+#define MEMORIA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "Dados.h"
+
+/**
+ * @file Memoria.h
+ * @brief Arenas de objetos de tamanho fixo (nós do grafo e efeitos nefastos).
+ * @author João Novais
+ * @date 2025-05-18
+ */
+
+/**
+ * @brief Inicializa uma arena vazia.
+ * @param a Ponteiro para a arena.
+ * @param tamanhoObjeto Tamanho de cada objeto, em bytes.
+ * @return true se inicializou, false caso contrário.
+ */
+bool iniciarArena(Arena* a, size_t tamanhoObjeto);
+
+/**
+ * @brief Reserva um objeto da arena (reutiliza objetos devolvidos, se houver).
+ * @param a Ponteiro para a arena.
+ * @return Ponteiro para o objeto (não inicializado), ou NULL em caso de erro de memória.
+ */
+void* reservarArena(Arena* a);
+
+/**
+ * @brief Devolve um objeto à lista de livres da arena, para ser reutilizado.
+ * @param a Ponteiro para a arena.
+ * @param obj Objeto reservado desta arena.
+ * @return true se devolveu, false caso contrário.
+ */
+bool devolverArena(Arena* a, void* obj);
+
+/**
+ * @brief Liberta de uma vez todos os blocos da arena (todos os objetos deixam de ser válidos).
+ * @param a Ponteiro para a arena.
+ * @return true após libertar.
+ */
+bool libertarArena(Arena* a);
+
+#endif
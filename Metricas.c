@@ -0,0 +1,176 @@
+#ifndef METRICAS_C
+#define METRICAS_C
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 199309L // clock_gettime com -std=c11
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+#include "Metricas.h"
+/**
+ * @file Metricas.c
+ * @brief Implementação da instrumentação (contadores, tempos e exportação JSON).
+ * @author João Novais
+ * @date 2025-05-18
+ *
+ */
+
+#pragma region Metricas
+
+// Nomes das operações, pela ordem de OperacaoMetrica
+static const char* nomesOperacoes[NUM_OPERACOES_METRICA] = {
+    "lerMatrizAntenas",
+    "lerMapaEsparso",
+    "lerBinario",
+    "guardarBinario",
+    "guardarBinarioV2",
+    "escreverMapaComEfeitos",
+    "escreverMapaEsparso",
+    "inserirAntena",
+    "RemoverAntena",
+    "conectarAntenasMesmoTipo",
+    "calcularEfeitosNefastos",
+    "calcularResultadoEfeitos",
+    "calcularConjuntoEfeitos",
+    "calcularResultadoEfeitosParalelo",
+    "DFSTraversal_Antena",
+    "congelarGrafo",
+    "rotularComponentes",
+    "calcularEfeitosRegiao",
+    "calcularEfeitosHarmonicos",
+    "guardarBinarioCompactado",
+    "inserirAntenasLote",
+    "antenasRetangulo",
+    "antenasRaio",
+    "antenasMaisProximas",
+    "publicarGrafo",
+    "abrirDiario",
+    "compactarDiario",
+    "definirEfeitosIncrementais"
+};
+
+/**
+ * @brief Indica se a biblioteca foi compilada com instrumentação.
+ * @return true se EDA_INSTRUMENTACAO estava definido, false caso contrário.
+ */
+bool instrumentacaoAtiva(void) {
+#ifdef EDA_INSTRUMENTACAO
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Devolve o instante atual, em segundos, de um relógio monotónico.
+ * @return Tempo em segundos.
+ */
+double relogioMetricas(void) {
+#ifdef _WIN32
+    LARGE_INTEGER freq, t;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&t);
+    return (double)t.QuadPart / (double)freq.QuadPart;
+#else
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double)t.tv_sec + (double)t.tv_nsec * 1e-9;
+#endif
+}
+
+/**
+ * @brief Acumula uma chamada e o tempo decorrido numa operação.
+ * @param m Ponteiro para as métricas.
+ * @param op Operação medida.
+ * @param inicio Instante de início (relogioMetricas).
+ * @return true se registou, false se os argumentos forem inválidos.
+ */
+bool registarTempoMetricas(Metricas* m, OperacaoMetrica op, double inicio) {
+    if (!m || op < 0 || op >= NUM_OPERACOES_METRICA) return false;
+    m->chamadas[op]++;
+    m->segundos[op] += relogioMetricas() - inicio;
+    return true;
+}
+
+/**
+ * @brief Põe a zero todas as métricas do grafo.
+ * @param g Ponteiro para o grafo.
+ * @return true se reiniciou, false se o grafo for inválido.
+ */
+bool reiniciarMetricas(Grafo* g) {
+    if (!g) return false;
+    memset(&g->metricas, 0, sizeof(Metricas));
+    return true;
+}
+
+/**
+ * @brief Copia as métricas atuais do grafo.
+ * @param g Ponteiro para o grafo.
+ * @param m Ponteiro para onde copiar.
+ * @return true se copiou, false se os argumentos forem inválidos.
+ */
+bool obterMetricas(const Grafo* g, Metricas* m) {
+    if (!g || !m) return false;
+    *m = g->metricas;
+    return true;
+}
+
+/**
+ * @brief Devolve o nome de uma operação medida (o nome da função pública).
+ * @param op Operação.
+ * @return Nome da operação, ou NULL se for inválida.
+ */
+const char* nomeOperacaoMetrica(OperacaoMetrica op) {
+    if (op < 0 || op >= NUM_OPERACOES_METRICA) return NULL;
+    return nomesOperacoes[op];
+}
+
+/**
+ * @brief Escreve as métricas do grafo num ficheiro JSON.
+ * @details Formato: {"instrumentacao": bool, "contadores": {...}, "operacoes": {"nome": {"chamadas": n,
+ *          "segundos": s}, ...}}; só aparecem as operações chamadas pelo menos uma vez.
+ * @param g Ponteiro para o grafo.
+ * @param filename Nome do ficheiro a escrever.
+ * @return true se escreveu, false caso contrário.
+ */
+bool exportarMetricasJSON(const Grafo* g, const char* filename) {
+    if (!g || !filename) return false;
+    FILE* f = fopen(filename, "w");
+    if (!f) return false;
+
+    const Metricas* m = &g->metricas;
+    fprintf(f, "{\n  \"instrumentacao\": %s,\n", instrumentacaoAtiva() ? "true" : "false");
+    fprintf(f, "  \"contadores\": {\n");
+    fprintf(f, "    \"paresExaminados\": %lld,\n", m->paresExaminados);
+    fprintf(f, "    \"sondagensEfeito\": %lld,\n", m->sondagensEfeito);
+    fprintf(f, "    \"efeitosEncontrados\": %lld,\n", m->efeitosEncontrados);
+    fprintf(f, "    \"verticesReservados\": %lld,\n", m->verticesReservados);
+    fprintf(f, "    \"adjacentesReservados\": %lld,\n", m->adjacentesReservados);
+    fprintf(f, "    \"verificacoesDuplicado\": %lld,\n", m->verificacoesDuplicado);
+    fprintf(f, "    \"bytesLidos\": %lld,\n", m->bytesLidos);
+    fprintf(f, "    \"bytesEscritos\": %lld\n", m->bytesEscritos);
+    fprintf(f, "  },\n  \"operacoes\": {");
+    bool primeira = true;
+    for (int op = 0; op < NUM_OPERACOES_METRICA; op++) {
+        if (m->chamadas[op] == 0) continue;
+        fprintf(f, "%s\n    \"%s\": {\"chamadas\": %lld, \"segundos\": %.9f}", primeira ? "" : ",",
+                nomesOperacoes[op], m->chamadas[op], m->segundos[op]);
+        primeira = false;
+    }
+    fprintf(f, "%s}\n}\n", primeira ? "" : "\n  ");
+
+    bool ok = !ferror(f);
+    if (fclose(f) != 0) ok = false;
+    return ok;
+}
+
+#pragma endregion
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef METRICAS_H
+#define METRICAS_H
+
+#include <stdbool.h>
+#include "Dados.h"
+
+/**
+ * @file Metricas.h
+ * @brief Instrumentação opcional (contadores e tempos por grafo), exportável em JSON.
+ * @details Compilar a biblioteca com -DEDA_INSTRUMENTACAO para ativar; sem essa definição as macros abaixo não
+ *          geram código e Grafo::metricas fica a zero.
+ *          Os tempos são inclusivos: uma operação medida que chama outra (lerBinario e inserirAntenasLote,
+ *          publicarGrafo e congelarGrafo) conta o tempo nas duas. Funções públicas excluídas de propósito:
+ *          - inserirVertice, removerVertice, procurarAntena e inserirAdjacente: primitivas por antena ou por
+ *            ligação, chamadas dentro das operações medidas (RemoverAntena é removerVertice); ler o relógio em
+ *            cada chamada custaria tanto como a própria operação. O trabalho aparece nos contadores.
+ *          - DFS e DFS_Antena: recursivas, cada nível seria contado como uma chamada; a travessia completa é
+ *            medida em DFSTraversal_Antena.
+ *          - processarLote: não recebe grafo; cada tarefa usa um grafo próprio, destruído no fim da tarefa,
+ *            pelo que não há onde guardar o tempo.
+ *          - Funções sobre GrafoCompacto e VersaoGrafo (DFSCompacto, adquirirVersao, ...): só de leitura e
+ *            usadas por várias threads ao mesmo tempo, sem Grafo a que somar o tempo.
+ * @author João Novais
+ * @date 2025-05-18
+ */
+
+#ifdef EDA_INSTRUMENTACAO
+// Soma n a um contador das métricas do grafo
+#define METRICA_CONTAR(g, campo, n) ((g)->metricas.campo += (n))
+// Guarda em t o instante de início de uma operação
+#define METRICA_INICIO(t) double t = relogioMetricas()
+// Acumula o tempo decorrido desde t na operação op do grafo
+#define METRICA_FIM(g, op, t) ((g) ? registarTempoMetricas(&(g)->metricas, (op), (t)) : false)
+#else
+// Sem instrumentação nada é avaliado (sizeof só verifica que o campo existe)
+#define METRICA_CONTAR(g, campo, n) ((void)sizeof((g)->metricas.campo))
+#define METRICA_INICIO(t) ((void)0)
+#define METRICA_FIM(g, op, t) ((void)0)
+#endif
+
+/**
+ * @brief Indica se a biblioteca foi compilada com instrumentação.
+ * @return true se EDA_INSTRUMENTACAO estava definido, false caso contrário.
+ */
+bool instrumentacaoAtiva(void);
+
+/**
+ * @brief Devolve o instante atual, em segundos, de um relógio monotónico.
+ * @return Tempo em segundos.
+ */
+double relogioMetricas(void);
+
+/**
+ * @brief Acumula uma chamada e o tempo decorrido numa operação.
+ * @param m Ponteiro para as métricas.
+ * @param op Operação medida.
+ * @param inicio Instante de início (relogioMetricas).
+ * @return true se registou, false se os argumentos forem inválidos.
+ */
+bool registarTempoMetricas(Metricas* m, OperacaoMetrica op, double inicio);
+
+/**
+ * @brief Põe a zero todas as métricas do grafo.
+ * @param g Ponteiro para o grafo.
+ * @return true se reiniciou, false se o grafo for inválido.
+ */
+bool reiniciarMetricas(Grafo* g);
+
+/**
+ * @brief Copia as métricas atuais do grafo.
+ * @param g Ponteiro para o grafo.
+ * @param m Ponteiro para onde copiar.
+ * @return true se copiou, false se os argumentos forem inválidos.
+ */
+bool obterMetricas(const Grafo* g, Metricas* m);
+
+/**
+ * @brief Devolve o nome de uma operação medida (o nome da função pública).
+ * @param op Operação.
+ * @return Nome da operação, ou NULL se for inválida.
+ */
+const char* nomeOperacaoMetrica(OperacaoMetrica op);
+
+/**
+ * @brief Escreve as métricas do grafo num ficheiro JSON.
+ * @param g Ponteiro para o grafo.
+ * @param filename Nome do ficheiro a escrever.
+ * @return true se escreveu, false caso contrário.
+ */
+bool exportarMetricasJSON(const Grafo* g, const char* filename);
+
+#endif
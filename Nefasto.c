@@ -4,11 +4,17 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <limits.h>
 #include <math.h>
 #include "Antena.h"
 #include "Grafo.h"
 #include "Nefasto.h"
 #include "Ficheiros.h"
+#include "Indice.h"
+#include "Memoria.h"
+#include "Metricas.h"
 /**
  * @file Nefasto.c
  * @brief Implementação das funções para efeitos nefastos.
@@ -38,10 +44,11 @@ EfeitoNefasto* CriarNafsto(int linha, int coluna) {
  * @param linha Linha do novo efeito.
  * @param coluna Coluna do novo efeito.
  * @param freq Frequência associada ao efeito.
- * @return Ponteiro para o início da lista atualizada.
+ * @return Ponteiro para o início da lista atualizada (a mesma lista se faltar memória).
  */
 EfeitoNefasto* inserirEfeito(EfeitoNefasto* lista, int linha, int coluna, char freq) {
     EfeitoNefasto* novo = malloc(sizeof(EfeitoNefasto));
+    if (!novo) return lista;
     novo->linha = linha;
     novo->coluna = coluna;
     novo->frequencia = freq;
@@ -49,6 +56,40 @@ EfeitoNefasto* inserirEfeito(EfeitoNefasto* lista, int linha, int coluna, char f
     return novo;
 }
 
+/**
+ * @brief Insere um efeito nefasto na lista, reservando o nó de uma arena.
+ * @param arena Arena de onde reservar o nó (NULL para usar malloc).
+ * @param lista Lista de efeitos nefastos.
+ * @param linha Linha do novo efeito.
+ * @param coluna Coluna do novo efeito.
+ * @param freq Frequência associada ao efeito.
+ * @return Ponteiro para o início da lista atualizada (a mesma lista se faltar memória).
+ */
+EfeitoNefasto* inserirEfeitoArena(Arena* arena, EfeitoNefasto* lista, int linha, int coluna, char freq) {
+    if (!arena) return inserirEfeito(lista, linha, coluna, freq);
+    EfeitoNefasto* novo = (EfeitoNefasto*)reservarArena(arena);
+    if (!novo) return lista;
+    novo->linha = linha;
+    novo->coluna = coluna;
+    novo->frequencia = freq;
+    novo->proximo = lista;
+    return novo;
+}
+
+/**
+ * @brief Liberta uma lista de efeitos criada com inserirEfeito (nó a nó).
+ * @param lista Lista de efeitos nefastos.
+ * @return true após libertar.
+ */
+bool libertarListaEfeitos(EfeitoNefasto* lista) {
+    while (lista) {
+        EfeitoNefasto* temp = lista;
+        lista = lista->proximo;
+        free(temp);
+    }
+    return true;
+}
+
 /**
  * @brief Verifica se já existe um efeito nefasto numa posição.
  * @param lista Lista de efeitos nefastos.
@@ -66,45 +107,624 @@ bool existeEfeito(EfeitoNefasto* lista, int linha, int coluna) {
 }
 
 /**
- * @brief Calcula todos os efeitos nefastos do grafo.
+ * @brief Calcula as posições dos efeitos nefastos de um par de antenas da mesma frequência.
+ * @details Único sítio com a regra do efeito, usado pelos cálculos completo, incremental, paralelo e compacto.
+ * @param linha1 Linha da primeira antena.
+ * @param coluna1 Coluna da primeira antena.
+ * @param linha2 Linha da segunda antena.
+ * @param coluna2 Coluna da segunda antena.
+ * @param posicoes Destino das posições válidas ({linha, coluna}), a partir do início.
+ * @return Número de posições válidas (0 a 2).
+ */
+int posicoesEfeitoPar(int linha1, int coluna1, int linha2, int coluna2, int posicoes[2][2]) {
+    int deltaLinha = linha2 - linha1;
+    int deltaColuna = coluna2 - coluna1;
+    int candidatas[2][2] = {
+        { linha1 - deltaLinha, coluna1 - deltaColuna },
+        { linha2 + deltaLinha, coluna2 + deltaColuna }
+    };
+    int n = 0;
+    for (int k = 0; k < 2; k++) {
+        if (candidatas[k][0] < 0 || candidatas[k][1] < 0) continue;
+        posicoes[n][0] = candidatas[k][0];
+        posicoes[n][1] = candidatas[k][1];
+        n++;
+    }
+    return n;
+}
+
+/**
+ * @brief Acrescenta um efeito ao início de uma lista, detetando a falta de memória.
+ * @param lista Ponteiro para a lista de efeitos.
+ * @param arena Arena de onde reservar o nó (NULL para usar malloc).
+ * @param linha Linha do efeito.
+ * @param coluna Coluna do efeito.
+ * @param freq Frequência associada ao efeito.
+ * @return true se acrescentou, false em caso de erro de memória.
+ */
+static bool acrescentarEfeito(EfeitoNefasto** lista, Arena* arena, int linha, int coluna, char freq) {
+    EfeitoNefasto* nova = inserirEfeitoArena(arena, *lista, linha, coluna, freq);
+    if (nova == *lista) return false;
+    *lista = nova;
+    return true;
+}
+
+/**
+ * @brief Acrescenta uma posição a um conjunto, distinguindo "já existia" de falta de memória.
+ * @param conjunto Ponteiro para o conjunto.
+ * @param linha Linha.
+ * @param coluna Coluna.
+ * @return 1 se a posição é nova, 0 se já existia, -1 em caso de erro de memória.
+ */
+static int marcarPosicaoEfeito(ConjuntoPosicoes* conjunto, int linha, int coluna) {
+    if (adicionarConjuntoPosicoes(conjunto, linha, coluna)) return 1;
+    return pertenceConjuntoPosicoes(conjunto, linha, coluna) ? 0 : -1;
+}
+
+/**
+ * @brief Marca um resultado como falhado por falta de memória.
+ * @details O resultado parcial é libertado e numEfeitos fica -1, para não se confundir com "sem efeitos"
+ *          (a mesma regra que calcularResultadoEfeitosParalelo).
+ * @param resultado Resultado a marcar.
+ * @return false, para ser devolvido diretamente.
+ */
+static bool falharResultadoEfeitos(ResultadoEfeitos* resultado) {
+    libertarEfeitos(resultado);
+    resultado->numEfeitos = -1;
+    return false;
+}
+
+/**
+ * @brief Acumula os efeitos nefastos de todos os pares de um balde de frequência.
+ * @param g Ponteiro para o grafo (métricas).
+ * @param b Ponteiro para o balde.
+ * @param conjunto Conjunto de posições já com efeito (evita repetidos).
+ * @param lista Ponteiro para a lista de efeitos a completar, ou NULL se só interessar o conjunto.
+ * @param arena Arena de onde reservar os nós da lista (NULL para usar malloc).
+ * @return true se acumulou, false em caso de erro de memória (o conjunto e a lista ficam incompletos).
+ */
+static bool acumularEfeitosBalde(Grafo* g, BaldeFrequencia* b, ConjuntoPosicoes* conjunto, EfeitoNefasto** lista, Arena* arena) {
+    METRICA_CONTAR(g, paresExaminados, (long long)b->numAntenas * (b->numAntenas - 1) / 2);
+    for (int i = 0; i < b->numAntenas; i++) {
+        VAntena* atual = b->antenas[i];
+        for (int j = i + 1; j < b->numAntenas; j++) {
+            VAntena* atual2 = b->antenas[j];
+            int efeitos[2][2];
+            int n = posicoesEfeitoPar(atual->linha, atual->coluna, atual2->linha, atual2->coluna, efeitos);
+            METRICA_CONTAR(g, sondagensEfeito, n);
+            for (int k = 0; k < n; k++) {
+                int nova = marcarPosicaoEfeito(conjunto, efeitos[k][0], efeitos[k][1]);
+                if (nova < 0) return false;
+                if (nova && lista && !acrescentarEfeito(lista, arena, efeitos[k][0], efeitos[k][1], atual->frequencia))
+                    return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Valor de uma entrada de EfeitosIncrementais::total: contador nos bits altos, menor frequência no byte baixo
+#define TOTAL_CONTADOR(v) ((v) >> 8)
+#define TOTAL_FREQUENCIA(v) ((v) & 0xFF)
+#define TOTAL_VALOR(contador, freq) (((intptr_t)(contador) << 8) | (intptr_t)(freq))
+
+/**
+ * @brief Procura a menor frequência, a partir de uma dada, com contribuições numa posição.
+ * @param ef Ponteiro para o mapa de efeitos.
+ * @param linha Linha.
+ * @param coluna Coluna.
+ * @param desde Primeira frequência a considerar.
+ * @return Frequência encontrada, ou NUM_FREQUENCIAS se nenhuma tiver contribuições.
+ */
+static int menorFrequenciaEfeito(EfeitosIncrementais* ef, int linha, int coluna, int desde) {
+    for (int f = desde; f < NUM_FREQUENCIAS; f++) {
+        if (ef->porFrequencia[f].ocupadas > 0 && procurarTabelaPosicoes(&ef->porFrequencia[f], linha, coluna)) return f;
+    }
+    return NUM_FREQUENCIAS;
+}
+
+/**
+ * @brief Acrescenta (ou retira) ao mapa incremental os dois efeitos de um par de antenas da mesma frequência.
+ * @details A menor frequência guardada em total só precisa de ser procurada de novo quando a frequência que lá
+ *          estava deixa de ter contribuições na posição.
+ * @param ef Ponteiro para o mapa de efeitos.
+ * @param a Primeira antena do par.
+ * @param b Segunda antena do par.
+ * @param sinal +1 para acrescentar, -1 para retirar.
+ * @return true se atualizou, false em caso de erro de memória.
+ */
+static bool contarEfeitosPar(EfeitosIncrementais* ef, VAntena* a, VAntena* b, int sinal) {
+    int freq = (unsigned char)a->frequencia;
+    TabelaPosicoes* porFrequencia = &ef->porFrequencia[freq];
+    int efeitos[2][2];
+    int n = posicoesEfeitoPar(a->linha, a->coluna, b->linha, b->coluna, efeitos);
+
+    for (int k = 0; k < n; k++) {
+        int linha = efeitos[k][0], coluna = efeitos[k][1];
+
+        // O contador vive no próprio valor da entrada; ao chegar a 0 a posição sai da tabela
+        intptr_t daFrequencia = (intptr_t)procurarTabelaPosicoes(porFrequencia, linha, coluna) + sinal;
+        if (daFrequencia > 0) {
+            if (!inserirTabelaPosicoes(porFrequencia, linha, coluna, (void*)daFrequencia)) return false;
+        } else {
+            removerTabelaPosicoes(porFrequencia, linha, coluna);
+        }
+
+        intptr_t anterior = (intptr_t)procurarTabelaPosicoes(&ef->total, linha, coluna);
+        intptr_t contador = TOTAL_CONTADOR(anterior) + sinal;
+        int menor = anterior ? (int)TOTAL_FREQUENCIA(anterior) : freq;
+        if (sinal > 0 && freq < menor) menor = freq;
+        if (sinal < 0 && daFrequencia == 0 && freq == menor) menor = menorFrequenciaEfeito(ef, linha, coluna, freq + 1);
+        if (contador > 0) {
+            if (!inserirTabelaPosicoes(&ef->total, linha, coluna, (void*)TOTAL_VALOR(contador, menor))) return false;
+        } else {
+            removerTabelaPosicoes(&ef->total, linha, coluna);
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Constrói a lista de efeitos a partir do mapa incremental.
+ * @details Cada posição aparece uma vez, com a menor frequência que lá produz efeito (como no cálculo completo,
+ *          que percorre os baldes por ordem), já guardada na entrada de total: uma só passagem pela tabela.
  * @param g Ponteiro para o grafo.
- * @param status Ponteiro para bool que indica se encontrou efeitos.
- * @return Lista ligada de efeitos nefastos encontrados, ou NULL se nenhum.
+ * @param lista Ponteiro para a lista de efeitos a completar.
+ * @param arena Arena de onde reservar os nós da lista (NULL para usar malloc).
+ * @return true se exportou, false em caso de erro de memória (a lista fica incompleta).
  */
-EfeitoNefasto* calcularEfeitosNefastos(Grafo* g, bool* status) {
+static bool exportarEfeitosIncrementais(Grafo* g, EfeitoNefasto** lista, Arena* arena) {
+    EfeitosIncrementais* ef = &g->efeitos;
+    int posicao = 0;
+    for (EntradaPosicao* e = proximaEntradaTabela(&ef->total, &posicao); e != NULL;
+         e = proximaEntradaTabela(&ef->total, &posicao)) {
+        if (!acrescentarEfeito(lista, arena, e->linha, e->coluna, (char)TOTAL_FREQUENCIA((intptr_t)e->valor)))
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Corpo de calcularConjuntoEfeitos, sem a medição de tempo (ver calcularConjuntoEfeitos).
+ */
+static bool calcularConjuntoEfeitosInterno(Grafo* g, ConjuntoPosicoes* conjunto) {
+    if (!g || !conjunto) return false;
+    if (!iniciarConjuntoPosicoes(conjunto, g->linhas, g->colunas)) return false;
+
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+        if (!acumularEfeitosBalde(g, &g->baldes[f], conjunto, NULL, NULL)) {
+            // Um conjunto incompleto não se distingue de um válido: não fica nenhum
+            libertarConjuntoPosicoes(conjunto);
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Calcula o conjunto de posições afetadas por efeitos nefastos.
+ * @details Cada posição é testada/inserida em tempo constante (mapa de bits nos limites do mapa,
+ *          tabela de dispersão fora deles).
+ * @param g Ponteiro para o grafo.
+ * @param conjunto Conjunto a preencher (é inicializado pela função; libertar com libertarConjuntoPosicoes).
+ * @return true se calculou, false em caso de erro (incluindo falta de memória; o conjunto fica libertado).
+ */
+bool calcularConjuntoEfeitos(Grafo* g, ConjuntoPosicoes* conjunto) {
+    METRICA_INICIO(inicio);
+    bool r = calcularConjuntoEfeitosInterno(g, conjunto);
+    METRICA_FIM(g, METRICA_CONJUNTO_EFEITOS, inicio);
+    return r;
+}
+
+/**
+ * @brief Corpo de calcularEfeitosNefastos, sem a medição de tempo (ver calcularEfeitosNefastos).
+ */
+static EfeitoNefasto* calcularEfeitosNefastosInterno(Grafo* g, bool* status) {
     if (!g || !g->listaAntenas) return NULL; // Grafo vazio
 
     EfeitoNefasto* listaEfeitos = NULL;
-    VAntena* atual = g->listaAntenas;
-    VAntena* atual2 = atual->proximo;
 
     // Se não há pelo menos duas antenas, não há efeitos nefastos
-    if (!atual || !atual->proximo) return NULL;
+    if (g->numAntenas < 2) return NULL;
 
-    for (atual = g->listaAntenas; atual != NULL; atual = atual->proximo) {
-        for (atual2 = atual->proximo; atual2 != NULL; atual2 = atual2->proximo) {
-            if (atual->frequencia != atual2->frequencia) continue;
+    if (status) *status = false;
+    if (g->efeitos.ativos) {
+        if (!exportarEfeitosIncrementais(g, &listaEfeitos, NULL)) {
+            libertarListaEfeitos(listaEfeitos);
+            return NULL;
+        }
+        METRICA_CONTAR(g, efeitosEncontrados, g->efeitos.total.ocupadas);
+        if (status) *status = (listaEfeitos != NULL);
+        return listaEfeitos;
+    }
 
-            int deltaLinha = atual2->linha - atual->linha;
-            int deltaColuna = atual2->coluna - atual->coluna;
+    ConjuntoPosicoes vistos;
+    if (!iniciarConjuntoPosicoes(&vistos, g->linhas, g->colunas)) return NULL;
 
-            int efeitoLinha1 = atual->linha - deltaLinha;
-            int efeitoColuna1 = atual->coluna - deltaColuna;
+    // Só pares da mesma frequência produzem efeitos: percorre cada balde
+    bool ok = true;
+    for (int f = 0; f < NUM_FREQUENCIAS && ok; f++) {
+        ok = acumularEfeitosBalde(g, &g->baldes[f], &vistos, &listaEfeitos, NULL);
+    }
+    METRICA_CONTAR(g, efeitosEncontrados, vistos.numPosicoes);
+    libertarConjuntoPosicoes(&vistos);
+    if (!ok) {
+        // Uma lista incompleta passaria por válida: sem memória não se devolve nenhuma
+        libertarListaEfeitos(listaEfeitos);
+        return NULL;
+    }
 
-            int efeitoLinha2 = atual2->linha + deltaLinha;
-            int efeitoColuna2 = atual2->coluna + deltaColuna;
+    if (status) *status = (listaEfeitos != NULL);
+    return listaEfeitos;
+}
 
-            if (efeitoLinha1 >= 0 && efeitoColuna1 >= 0 &&
-                !existeEfeito(listaEfeitos, efeitoLinha1, efeitoColuna1))
-                listaEfeitos = inserirEfeito(listaEfeitos, efeitoLinha1, efeitoColuna1, atual->frequencia);
+/**
+ * @brief Calcula todos os efeitos nefastos do grafo.
+ * @param g Ponteiro para o grafo.
+ * @param status Ponteiro para bool que indica se encontrou efeitos.
+ * @return Lista ligada de efeitos nefastos encontrados, ou NULL se nenhum ou por falta de memória.
+ */
+EfeitoNefasto* calcularEfeitosNefastos(Grafo* g, bool* status) {
+    METRICA_INICIO(inicio);
+    EfeitoNefasto* r = calcularEfeitosNefastosInterno(g, status);
+    METRICA_FIM(g, METRICA_EFEITOS, inicio);
+    return r;
+}
+
+/**
+ * @brief Corpo de calcularResultadoEfeitos, sem a medição de tempo (ver calcularResultadoEfeitos).
+ */
+static bool calcularResultadoEfeitosInterno(Grafo* g, ResultadoEfeitos* resultado) {
+    if (!resultado) return false;
+    resultado->lista = NULL;
+    resultado->numEfeitos = 0;
+    iniciarArena(&resultado->arena, sizeof(EfeitoNefasto));
+    if (!g || g->numAntenas < 2) return false;
 
-            if (efeitoLinha2 >= 0 && efeitoColuna2 >= 0 &&
-                !existeEfeito(listaEfeitos, efeitoLinha2, efeitoColuna2))
-                listaEfeitos = inserirEfeito(listaEfeitos, efeitoLinha2, efeitoColuna2, atual->frequencia);
+    bool ok = true;
+    if (g->efeitos.ativos) {
+        ok = exportarEfeitosIncrementais(g, &resultado->lista, &resultado->arena);
+    } else {
+        ConjuntoPosicoes vistos;
+        ok = iniciarConjuntoPosicoes(&vistos, g->linhas, g->colunas);
+        for (int f = 0; f < NUM_FREQUENCIAS && ok; f++) {
+            ok = acumularEfeitosBalde(g, &g->baldes[f], &vistos, &resultado->lista, &resultado->arena);
         }
+        libertarConjuntoPosicoes(&vistos);
     }
-    if (status) *status = (listaEfeitos != NULL);
-    return listaEfeitos;
+    if (!ok) return falharResultadoEfeitos(resultado);
+    resultado->numEfeitos = resultado->arena.numObjetos;
+    METRICA_CONTAR(g, efeitosEncontrados, resultado->numEfeitos);
+    return resultado->lista != NULL;
+}
+
+/**
+ * @brief Calcula todos os efeitos nefastos do grafo para um resultado com arena própria.
+ * @param g Ponteiro para o grafo.
+ * @param resultado Resultado a preencher (libertar com libertarEfeitos).
+ * @return true se encontrou efeitos; false sem efeitos (resultado->numEfeitos == 0) ou por falta de memória
+ *         (resultado->numEfeitos == -1).
+ */
+bool calcularResultadoEfeitos(Grafo* g, ResultadoEfeitos* resultado) {
+    METRICA_INICIO(inicio);
+    bool r = calcularResultadoEfeitosInterno(g, resultado);
+    METRICA_FIM(g, METRICA_RESULTADO_EFEITOS, inicio);
+    return r;
+}
+
+/**
+ * @brief Primeira antena de um vetor ordenado por (linha, coluna) que não está antes de (linha, coluna).
+ * @param v Vetor ordenado.
+ * @param inicio Primeiro índice a considerar.
+ * @param num Número de antenas do vetor.
+ * @param linha Linha.
+ * @param coluna Coluna.
+ * @return Índice encontrado (num se não houver nenhuma).
+ */
+static int primeiraAPartirDe(VAntena** v, int inicio, int num, long long linha, long long coluna) {
+    int esq = inicio, dir = num;
+    while (esq < dir) {
+        int meio = esq + (dir - esq) / 2;
+        if (v[meio]->linha < linha || (v[meio]->linha == linha && v[meio]->coluna < coluna))
+            esq = meio + 1;
+        else
+            dir = meio;
+    }
+    return esq;
+}
+
+/**
+ * @brief Corpo de calcularEfeitosRegiao, sem a medição de tempo (ver calcularEfeitosRegiao).
+ */
+static bool calcularEfeitosRegiaoInterno(Grafo* g, int linhaMin, int colunaMin, int linhaMax, int colunaMax,
+                                         ResultadoEfeitos* resultado) {
+    if (!resultado) return false;
+    resultado->lista = NULL;
+    resultado->numEfeitos = 0;
+    iniciarArena(&resultado->arena, sizeof(EfeitoNefasto));
+    if (!g || g->numAntenas < 2) return false;
+
+    // Os efeitos fora do mapa só contam com coordenadas não negativas (como no cálculo completo)
+    if (linhaMin < 0) linhaMin = 0;
+    if (colunaMin < 0) colunaMin = 0;
+    if (linhaMin > linhaMax || colunaMin > colunaMax) return false;
+
+    // O conjunto usa coordenadas relativas ao retângulo (mapa de bits se couber, tabela caso contrário)
+    long long altura = (long long)linhaMax - linhaMin + 1, largura = (long long)colunaMax - colunaMin + 1;
+    ConjuntoPosicoes vistos;
+    if (!iniciarConjuntoPosicoes(&vistos, altura <= INT_MAX ? (int)altura : 0, largura <= INT_MAX ? (int)largura : 0))
+        return falharResultadoEfeitos(resultado);
+
+    bool ok = true;
+    for (int f = 0; f < NUM_FREQUENCIAS && ok; f++) {
+        BaldeFrequencia* b = &g->baldes[f];
+        if (b->numAntenas < 2) continue;
+        if (!ordenarBaldePorLinha(b)) {
+            ok = false;
+            break;
+        }
+        VAntena** v = b->porLinha;
+        int n = b->numAntenas;
+        // O efeito de a do lado oposto a c é 2a - c: cai no retângulo só se c estiver no retângulo refletido em a.
+        // Como a é o ponto médio entre o efeito e c, só interessam as linhas de a entre as da janela e as do balde
+        long long primeiraLinha = ((long long)linhaMin + v[0]->linha) / 2;
+        long long ultimaLinha = ((long long)linhaMax + v[n - 1]->linha + 1) / 2;
+        for (int i = primeiraAPartirDe(v, 0, n, primeiraLinha, INT_MIN); i < n && v[i]->linha <= ultimaLinha; i++) {
+            VAntena* a = v[i];
+            long long linhaDe = 2LL * a->linha - linhaMax, linhaAte = 2LL * a->linha - linhaMin;
+            long long colunaDe = 2LL * a->coluna - colunaMax, colunaAte = 2LL * a->coluna - colunaMin;
+            int k = primeiraAPartirDe(v, 0, n, linhaDe, colunaDe);
+            while (k < n && v[k]->linha <= linhaAte) {
+                VAntena* c = v[k];
+                if (c->coluna < colunaDe) {
+                    k = primeiraAPartirDe(v, k, n, c->linha, colunaDe);
+                    continue;
+                }
+                if (c->coluna > colunaAte) {
+                    k = primeiraAPartirDe(v, k, n, (long long)c->linha + 1, colunaDe);
+                    continue;
+                }
+                k++;
+                if (c == a) continue;
+                METRICA_CONTAR(g, paresExaminados, 1);
+                METRICA_CONTAR(g, sondagensEfeito, 1);
+                int linha = (int)(2LL * a->linha - c->linha), coluna = (int)(2LL * a->coluna - c->coluna);
+                int nova = marcarPosicaoEfeito(&vistos, linha - linhaMin, coluna - colunaMin);
+                if (nova < 0 ||
+                    (nova && !acrescentarEfeito(&resultado->lista, &resultado->arena, linha, coluna, a->frequencia))) {
+                    ok = false;
+                    break;
+                }
+            }
+            if (!ok) break;
+        }
+    }
+    libertarConjuntoPosicoes(&vistos);
+    if (!ok) return falharResultadoEfeitos(resultado);
+    resultado->numEfeitos = resultado->arena.numObjetos;
+    METRICA_CONTAR(g, efeitosEncontrados, resultado->numEfeitos);
+    return resultado->lista != NULL;
+}
+
+/**
+ * @brief Calcula só os efeitos nefastos que caem dentro de um retângulo (limites incluídos).
+ * @details Cada balde é percorrido pela sua cópia ordenada por (linha, coluna). Para cada antena a, só as antenas
+ *          c do retângulo refletido em a (pesquisa binária por linha e, em cada linha, por coluna) produzem um efeito
+ *          2a - c dentro da janela; os restantes pares nem são visitados. O custo depende das antenas e efeitos
+ *          perto da janela, não do mapa inteiro.
+ * @param g Ponteiro para o grafo.
+ * @param linhaMin Primeira linha.
+ * @param colunaMin Primeira coluna.
+ * @param linhaMax Última linha.
+ * @param colunaMax Última coluna.
+ * @param resultado Resultado a preencher (libertar com libertarEfeitos).
+ * @return true se encontrou efeitos; false sem efeitos (resultado->numEfeitos == 0) ou por falta de memória
+ *         (resultado->numEfeitos == -1).
+ */
+bool calcularEfeitosRegiao(Grafo* g, int linhaMin, int colunaMin, int linhaMax, int colunaMax, ResultadoEfeitos* resultado) {
+    METRICA_INICIO(inicio);
+    bool r = calcularEfeitosRegiaoInterno(g, linhaMin, colunaMin, linhaMax, colunaMax, resultado);
+    METRICA_FIM(g, METRICA_EFEITOS_REGIAO, inicio);
+    return r;
+}
+
+/**
+ * @brief Máximo divisor comum de dois inteiros não negativos.
+ * @param a Primeiro inteiro.
+ * @param b Segundo inteiro.
+ * @return mdc(a, b).
+ */
+static long long maximoDivisorComum(long long a, long long b) {
+    while (b != 0) {
+        long long r = a % b;
+        a = b;
+        b = r;
+    }
+    return a;
+}
+
+/**
+ * @brief Divisão inteira arredondada para baixo (o divisor tem de ser positivo).
+ * @param a Dividendo.
+ * @param b Divisor (> 0).
+ * @return floor(a / b).
+ */
+static long long divisaoChao(long long a, long long b) {
+    long long q = a / b;
+    return (a % b != 0 && a < 0) ? q - 1 : q;
+}
+
+/**
+ * @brief Restringe o intervalo de passos t para que p + t*passo fique em [0, limite).
+ * @param p Coordenada de partida.
+ * @param passo Passo (qualquer sinal).
+ * @param limite Dimensão do mapa nesse eixo.
+ * @param tMin Ponteiro para o menor passo (é atualizado).
+ * @param tMax Ponteiro para o maior passo (é atualizado).
+ */
+static void limitarPassos(long long p, long long passo, long long limite, long long* tMin, long long* tMax) {
+    long long de, ate;
+    if (passo == 0) {
+        if (p < 0 || p >= limite) *tMax = *tMin - 1;
+        return;
+    }
+    if (passo > 0) {
+        de = -divisaoChao(p, passo); // ceil(-p / passo)
+        ate = divisaoChao(limite - 1 - p, passo);
+    } else {
+        de = -divisaoChao(limite - 1 - p, -passo); // ceil((p - limite + 1) / |passo|)
+        ate = divisaoChao(p, -passo);
+    }
+    if (de > *tMin) *tMin = de;
+    if (ate < *tMax) *tMax = ate;
+}
+
+/**
+ * @brief Marca as células do mapa sobre uma reta, a partir de uma antena e com o passo mínimo da reta.
+ * @param g Ponteiro para o grafo (dimensões e métricas).
+ * @param origem Antena sobre a reta.
+ * @param passoLinha Passo em linhas (delta / mdc).
+ * @param passoColuna Passo em colunas (delta / mdc).
+ * @param conjunto Mapa das células já marcadas.
+ * @param resultado Resultado onde acrescentar as células novas.
+ * @return true se marcou, false em caso de erro de memória.
+ */
+static bool percorrerRetaHarmonica(Grafo* g, VAntena* origem, long long passoLinha, long long passoColuna,
+                                   ConjuntoPosicoes* conjunto, ResultadoEfeitos* resultado) {
+    long long tMin = -LLONG_MAX, tMax = LLONG_MAX;
+    limitarPassos(origem->linha, passoLinha, g->linhas, &tMin, &tMax);
+    limitarPassos(origem->coluna, passoColuna, g->colunas, &tMin, &tMax);
+    for (long long t = tMin; t <= tMax; t++) {
+        int linha = (int)(origem->linha + t * passoLinha);
+        int coluna = (int)(origem->coluna + t * passoColuna);
+        METRICA_CONTAR(g, sondagensEfeito, 1);
+        int nova = marcarPosicaoEfeito(conjunto, linha, coluna);
+        if (nova < 0 ||
+            (nova && !acrescentarEfeito(&resultado->lista, &resultado->arena, linha, coluna, origem->frequencia)))
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Marca todas as células do mapa sobre as retas que passam por pares de antenas de um balde.
+ * @details Cada reta é percorrida uma só vez, a partir da antena de menor índice do balde que está sobre ela:
+ *          para cada antena, as outras são agrupadas pela direção reduzida (delta / mdc, com sinal normalizado)
+ *          numa tabela com o menor índice de cada direção, e só as direções em que esse índice é maior que o da
+ *          própria antena são percorridas. Com k antenas colineares a reta é percorrida uma vez e não k² vezes.
+ *          Direções com passo fora dos inteiros (no máximo uma célula dentro do mapa) são percorridas sem agrupar.
+ * @param g Ponteiro para o grafo (dimensões e métricas).
+ * @param b Ponteiro para o balde.
+ * @param conjunto Mapa das células já marcadas.
+ * @param resultado Resultado onde acrescentar as células novas.
+ * @return true se marcou, false em caso de erro de memória.
+ */
+static bool acumularHarmonicosBalde(Grafo* g, BaldeFrequencia* b, ConjuntoPosicoes* conjunto, ResultadoEfeitos* resultado) {
+    METRICA_CONTAR(g, paresExaminados, (long long)b->numAntenas * (b->numAntenas - 1) / 2);
+    if (b->numAntenas < 2) return true;
+
+    TabelaPosicoes direcoes;
+    if (!iniciarTabelaPosicoes(&direcoes)) return false;
+    for (int i = 0; i < b->numAntenas; i++) {
+        VAntena* atual = b->antenas[i];
+        for (int j = 0; j < b->numAntenas; j++) {
+            if (j == i) continue;
+            VAntena* outra = b->antenas[j];
+            long long deltaLinha = (long long)outra->linha - atual->linha;
+            long long deltaColuna = (long long)outra->coluna - atual->coluna;
+
+            // Passo mínimo entre células da reta: delta / mdc, com o sinal da linha (ou da coluna) positivo
+            long long d = maximoDivisorComum(deltaLinha < 0 ? -deltaLinha : deltaLinha,
+                                             deltaColuna < 0 ? -deltaColuna : deltaColuna);
+            long long passoLinha = deltaLinha / d, passoColuna = deltaColuna / d;
+            if (passoLinha < 0 || (passoLinha == 0 && passoColuna < 0)) {
+                passoLinha = -passoLinha;
+                passoColuna = -passoColuna;
+            }
+            if (passoLinha > INT_MAX || passoColuna > INT_MAX || passoColuna < -INT_MAX) {
+                if (j > i && !percorrerRetaHarmonica(g, atual, passoLinha, passoColuna, conjunto, resultado)) {
+                    libertarTabelaPosicoes(&direcoes);
+                    return false;
+                }
+                continue;
+            }
+            intptr_t menor = (intptr_t)procurarTabelaPosicoes(&direcoes, (int)passoLinha, (int)passoColuna);
+            if ((!menor || j + 1 < menor) &&
+                !inserirTabelaPosicoes(&direcoes, (int)passoLinha, (int)passoColuna, (void*)(intptr_t)(j + 1))) {
+                libertarTabelaPosicoes(&direcoes);
+                return false;
+            }
+        }
+
+        // Só as retas em que esta é a antena de menor índice
+        int posicao = 0;
+        for (EntradaPosicao* e = proximaEntradaTabela(&direcoes, &posicao); e != NULL;
+             e = proximaEntradaTabela(&direcoes, &posicao)) {
+            if ((intptr_t)e->valor - 1 > i && !percorrerRetaHarmonica(g, atual, e->linha, e->coluna, conjunto, resultado)) {
+                libertarTabelaPosicoes(&direcoes);
+                return false;
+            }
+        }
+        libertarTabelaPosicoes(&direcoes);
+    }
+    return true;
+}
+
+/**
+ * @brief Corpo de calcularEfeitosHarmonicos, sem a medição de tempo (ver calcularEfeitosHarmonicos).
+ */
+static bool calcularEfeitosHarmonicosInterno(Grafo* g, ResultadoEfeitos* resultado) {
+    if (!resultado) return false;
+    resultado->lista = NULL;
+    resultado->numEfeitos = 0;
+    iniciarArena(&resultado->arena, sizeof(EfeitoNefasto));
+    if (!g || g->numAntenas < 2 || g->linhas <= 0 || g->colunas <= 0) return false;
+
+    ConjuntoPosicoes marcadas;
+    if (!iniciarConjuntoPosicoes(&marcadas, g->linhas, g->colunas)) return falharResultadoEfeitos(resultado);
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+        if (!acumularHarmonicosBalde(g, &g->baldes[f], &marcadas, resultado)) {
+            libertarConjuntoPosicoes(&marcadas);
+            return falharResultadoEfeitos(resultado);
+        }
+    }
+    resultado->numEfeitos = resultado->arena.numObjetos;
+    METRICA_CONTAR(g, efeitosEncontrados, resultado->numEfeitos);
+    libertarConjuntoPosicoes(&marcadas);
+    return resultado->lista != NULL;
+}
+
+/**
+ * @brief Calcula os efeitos no modo harmónico: todas as células do mapa sobre a reta de cada par de antenas da mesma frequência.
+ * @details Em cada balde de frequência, cada reta definida por antenas do balde é percorrida uma só vez, a partir
+ *          da antena de menor índice sobre ela, com passo (deltaLinha, deltaColuna) / mdc, nos dois sentidos e só
+ *          entre os passos que ficam dentro do mapa (calculados à partida). Com k antenas num balde o custo é
+ *          O(k²) consultas a uma tabela de direções mais as células das retas distintas (uma reta partilhada por
+ *          várias antenas conta uma vez); as células onde retas se cruzam são detetadas no mapa de bits do conjunto.
+ *          As posições das próprias antenas também contam.
+ * @param g Ponteiro para o grafo (tem de ter as dimensões definidas).
+ * @param resultado Resultado a preencher (libertar com libertarEfeitos).
+ * @return true se encontrou efeitos; false sem efeitos (resultado->numEfeitos == 0) ou por falta de memória
+ *         (resultado->numEfeitos == -1).
+ */
+bool calcularEfeitosHarmonicos(Grafo* g, ResultadoEfeitos* resultado) {
+    METRICA_INICIO(inicio);
+    bool r = calcularEfeitosHarmonicosInterno(g, resultado);
+    METRICA_FIM(g, METRICA_EFEITOS_HARMONICOS, inicio);
+    return r;
+}
+
+/**
+ * @brief Liberta de uma vez todos os efeitos de um resultado.
+ * @param resultado Resultado a libertar.
+ * @return true após libertar.
+ */
+bool libertarEfeitos(ResultadoEfeitos* resultado) {
+    if (!resultado) return false;
+    libertarArena(&resultado->arena);
+    resultado->lista = NULL;
+    resultado->numEfeitos = 0;
+    return true;
 }
 
 /**
@@ -127,8 +747,89 @@ bool imprimirEfeitosNefastos(EfeitoNefasto* lista) {
     return true;// Efeitos impressos com sucesso
 }
 
+/**
+ * @brief Marca a escrever numa célula do mapa (coluna e carácter).
+ */
+typedef struct MarcaMapa {
+    int coluna;
+    char simbolo;
+} MarcaMapa;
+
+/**
+ * @brief Corpo de escreverMapaComEfeitos, sem a medição de tempo (ver escreverMapaComEfeitos).
+ */
+static bool escreverMapaComEfeitosInterno(const char* filename, Grafo* g, EfeitoNefasto* efeitos, int linhas, int colunas) {
+    if (!g || linhas < 0 || colunas < 0) return false;
+
+    // Conta as marcas de cada linha
+    int* inicio = calloc((size_t)linhas + 2, sizeof(int));
+    if (!inicio) return false;
+    int numMarcas = 0;
+    for (EfeitoNefasto* e = efeitos; e != NULL; e = e->proximo) {
+        if (e->linha >= 0 && e->linha < linhas && e->coluna >= 0 && e->coluna < colunas) {
+            inicio[e->linha + 2]++;
+            numMarcas++;
+        }
+    }
+    for (VAntena* ant = g->listaAntenas; ant != NULL; ant = ant->proximo) {
+        if (ant->linha >= 0 && ant->linha < linhas && ant->coluna >= 0 && ant->coluna < colunas) {
+            inicio[ant->linha + 2]++;
+            numMarcas++;
+        }
+    }
+    // inicio[l + 1] passa a ser a posição de escrita da linha l; no fim, inicio[l] é o início da linha l
+    for (int l = 2; l <= linhas + 1; l++) inicio[l] += inicio[l - 1];
+
+    MarcaMapa* marcas = malloc((size_t)(numMarcas ? numMarcas : 1) * sizeof(MarcaMapa));
+    char* buffer = malloc((size_t)colunas + 1);
+    if (!marcas || !buffer) {
+        free(inicio);
+        free(marcas);
+        free(buffer);
+        return false;
+    }
+    for (EfeitoNefasto* e = efeitos; e != NULL; e = e->proximo) {
+        if (e->linha >= 0 && e->linha < linhas && e->coluna >= 0 && e->coluna < colunas) {
+            MarcaMapa* m = &marcas[inicio[e->linha + 1]++];
+            m->coluna = e->coluna;
+            m->simbolo = '#';
+        }
+    }
+    for (VAntena* ant = g->listaAntenas; ant != NULL; ant = ant->proximo) {
+        if (ant->linha >= 0 && ant->linha < linhas && ant->coluna >= 0 && ant->coluna < colunas) {
+            MarcaMapa* m = &marcas[inicio[ant->linha + 1]++];
+            m->coluna = ant->coluna;
+            m->simbolo = ant->frequencia;
+        }
+    }
+
+    FILE* f = fopen(filename, "w");
+    if (!f) {
+        free(inicio);
+        free(marcas);
+        free(buffer);
+        return false;// Erro ao abrir o ficheiro
+    }
+    bool ok = true;
+    buffer[colunas] = '\n';
+    for (int i = 0; i < linhas && ok; i++) {
+        memset(buffer, '.', (size_t)colunas);
+        for (int k = inicio[i]; k < inicio[i + 1]; k++) buffer[marcas[k].coluna] = marcas[k].simbolo;
+        ok = fwrite(buffer, 1, (size_t)colunas + 1, f) == (size_t)colunas + 1;
+    }
+    METRICA_CONTAR(g, bytesEscritos, ftell(f));
+    if (fclose(f) != 0) ok = false;
+    free(inicio);
+    free(marcas);
+    free(buffer);
+    return ok;// Mapa escrito com sucesso
+}
+
 /**
  * @brief Escreve o mapa atualizado no ficheiro, colocando '#' onde há efeito nefasto.
+ * @details As antenas e os efeitos dentro do mapa são distribuídos por linha (ordenação por contagem) e cada
+ *          linha é montada num buffer e escrita com um só fwrite: O(linhas*colunas + N + E) no total.
+ *          Os efeitos são aplicados antes das antenas, para uma antena prevalecer sobre um efeito na mesma célula.
  * @param filename Nome do ficheiro a escrever.
  * @param g Ponteiro para o grafo.
  * @param efeitos Lista de efeitos nefastos.
@@ -136,37 +837,129 @@ bool imprimirEfeitosNefastos(EfeitoNefasto* lista) {
  * @param colunas Número de colunas do mapa.
  */
 bool escreverMapaComEfeitos(const char* filename, Grafo* g, EfeitoNefasto* efeitos, int linhas, int colunas) {
-    FILE* f = fopen(filename, "w");
-    if (!f) {
-        return false;// Erro ao abrir o ficheiro
+    METRICA_INICIO(inicio);
+    bool r = escreverMapaComEfeitosInterno(filename, g, efeitos, linhas, colunas);
+    METRICA_FIM(g, METRICA_ESCREVER_MAPA, inicio);
+    return r;
+}
+
+#pragma endregion
+
+#pragma region Efeitos Incrementais
+
+/**
+ * @brief Inicializa um mapa de efeitos incremental vazio (e desativado).
+ * @param ef Ponteiro para o mapa de efeitos.
+ * @return true se inicializou, false caso contrário.
+ */
+bool iniciarEfeitosIncrementais(EfeitosIncrementais* ef) {
+    if (!ef) return false;
+    ef->ativos = false;
+    iniciarTabelaPosicoes(&ef->total);
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) iniciarTabelaPosicoes(&ef->porFrequencia[f]);
+    return true;
+}
+
+/**
+ * @brief Esvazia um mapa de efeitos incremental, sem alterar se está ativo.
+ * @param ef Ponteiro para o mapa de efeitos.
+ * @return true após libertar.
+ */
+bool libertarEfeitosIncrementais(EfeitosIncrementais* ef) {
+    if (!ef) return false;
+    libertarTabelaPosicoes(&ef->total);
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) libertarTabelaPosicoes(&ef->porFrequencia[f]);
+    return true;
+}
+
+/**
+ * @brief Corpo de definirEfeitosIncrementais, sem a medição de tempo (ver definirEfeitosIncrementais).
+ */
+static bool definirEfeitosIncrementaisInterno(Grafo* g, bool incremental) {
+    if (!g) return false;
+    if (!incremental) {
+        g->efeitos.ativos = false;
+        return libertarEfeitosIncrementais(&g->efeitos);
     }
-    for (int i = 0; i < linhas; i++) {
-        for (int j = 0; j < colunas; j++) {
-            // Verifica se há antena nesta posição
-            VAntena* ant = g->listaAntenas;
-            bool temAntena = false;
-            char freq = '.';
-            while (ant) {
-                if (ant->linha == i && ant->coluna == j) {
-                    temAntena = true;
-                    freq = ant->frequencia;
-                    break;
+    if (g->efeitos.ativos) return true;
+
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+        BaldeFrequencia* b = &g->baldes[f];
+        for (int i = 0; i < b->numAntenas; i++) {
+            for (int j = i + 1; j < b->numAntenas; j++) {
+                if (!contarEfeitosPar(&g->efeitos, b->antenas[i], b->antenas[j], 1)) {
+                    libertarEfeitosIncrementais(&g->efeitos);
+                    return false;
                 }
-                ant = ant->proximo;
-            }
-            // Verifica se há efeito nefasto nesta posição
-            if (!temAntena && existeEfeito(efeitos, i, j)) {
-                fputc('#', f);
-            } else if (temAntena) {
-                fputc(freq, f);
-            } else {
-                fputc('.', f);
             }
         }
-        fputc('\n', f);
     }
-    fclose(f);
-    return true;// Mapa escrito com sucesso
+    g->efeitos.ativos = true;
+    return true;
+}
+
+/**
+ * @brief Ativa ou desativa a manutenção incremental dos efeitos nefastos.
+ * @details Ao ativar, o mapa é construído uma vez a partir dos baldes de frequência; a partir daí cada
+ *          inserção/remoção de antena só atualiza os pares dessa antena (O(k), com k antenas da mesma
+ *          frequência) e calcularEfeitosNefastos/calcularResultadoEfeitos passam a ler o mapa.
+ * @param g Ponteiro para o grafo.
+ * @param incremental true para ativar.
+ * @return true se alterou o modo, false em caso de erro.
+ */
+bool definirEfeitosIncrementais(Grafo* g, bool incremental) {
+    METRICA_INICIO(inicio);
+    bool r = definirEfeitosIncrementaisInterno(g, incremental);
+    METRICA_FIM(g, METRICA_EFEITOS_INCREMENTAIS, inicio);
+    return r;
+}
+
+/**
+ * @brief Acrescenta ou retira do mapa incremental os efeitos dos pares de uma antena.
+ * @details A antena tem de estar no balde da sua frequência. Se faltar memória a meio, o modo incremental é
+ *          desativado (o mapa ficaria inconsistente) e os cálculos voltam a ser completos.
+ * @param g Ponteiro para o grafo.
+ * @param ant Ponteiro para a antena.
+ * @param sinal +1 ao inserir a antena, -1 ao removê-la.
+ * @return true se atualizou, false se o modo não está ativo ou em caso de erro.
+ */
+bool atualizarEfeitosAntena(Grafo* g, VAntena* ant, int sinal) {
+    if (!g || !ant || !g->efeitos.ativos) return false;
+
+    BaldeFrequencia* b = baldeFrequencia(g, ant->frequencia);
+    METRICA_CONTAR(g, paresExaminados, b->numAntenas - 1);
+    for (int i = 0; i < b->numAntenas; i++) {
+        VAntena* outra = b->antenas[i];
+        if (outra == ant) continue;
+        if (!contarEfeitosPar(&g->efeitos, ant, outra, sinal)) {
+            g->efeitos.ativos = false;
+            libertarEfeitosIncrementais(&g->efeitos);
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Devolve quantas contribuições (par de antenas, lado) produzem efeito numa posição.
+ * @param g Ponteiro para o grafo.
+ * @param linha Linha.
+ * @param coluna Coluna.
+ * @return Número de contribuições (0 se não há efeito), ou -1 se o modo incremental não está ativo.
+ */
+int contribuicoesEfeito(Grafo* g, int linha, int coluna) {
+    if (!g || !g->efeitos.ativos) return -1;
+    return (int)TOTAL_CONTADOR((intptr_t)procurarTabelaPosicoes(&g->efeitos.total, linha, coluna));
+}
+
+/**
+ * @brief Devolve o número de posições com efeito nefasto no mapa incremental.
+ * @param g Ponteiro para o grafo.
+ * @return Número de posições, ou -1 se o modo incremental não está ativo.
+ */
+int numeroEfeitosIncrementais(Grafo* g) {
+    if (!g || !g->efeitos.ativos) return -1;
+    return g->efeitos.total.ocupadas;
 }
 
 #pragma endregion
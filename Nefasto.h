@@ -27,14 +27,142 @@ EfeitoNefasto* CriarNafsto(int linha, int coluna);
  */
 EfeitoNefasto* inserirEfeito(EfeitoNefasto* lista, int linha, int coluna, char freq);
 
+/**
+ * @brief Insere um efeito nefasto na lista, reservando o nó de uma arena.
+ * @param arena Arena de onde reservar o nó (NULL para usar malloc).
+ * @param lista Lista de efeitos nefastos.
+ * @param linha Linha.
+ * @param coluna Coluna.
+ * @param freq Frequência.
+ * @return Ponteiro para o início da lista atualizada.
+ */
+EfeitoNefasto* inserirEfeitoArena(Arena* arena, EfeitoNefasto* lista, int linha, int coluna, char freq);
+
+/**
+ * @brief Liberta uma lista de efeitos criada com inserirEfeito (nó a nó).
+ * @param lista Lista de efeitos nefastos.
+ * @return true após libertar.
+ */
+bool libertarListaEfeitos(EfeitoNefasto* lista);
+
 /**
  * @brief Calcula todos os efeitos nefastos do grafo.
  * @param g Ponteiro para o grafo.
  * @param status Ponteiro para bool que indica se encontrou efeitos.
- * @return Lista ligada de efeitos nefastos encontrados, ou NULL se nenhum.
+ * @return Lista ligada de efeitos nefastos encontrados, ou NULL se nenhum ou por falta de memória.
  */
 EfeitoNefasto* calcularEfeitosNefastos(Grafo* g, bool* status);
 
+/**
+ * @brief Calcula todos os efeitos nefastos do grafo para um resultado com arena própria.
+ * @param g Ponteiro para o grafo.
+ * @param resultado Resultado a preencher (libertar com libertarEfeitos).
+ * @return true se encontrou efeitos; false sem efeitos (resultado->numEfeitos == 0) ou por falta de memória
+ *         (resultado->numEfeitos == -1).
+ */
+bool calcularResultadoEfeitos(Grafo* g, ResultadoEfeitos* resultado);
+
+/**
+ * @brief Calcula só os efeitos nefastos que caem dentro de um retângulo (limites incluídos).
+ * @details O resultado é o de calcularResultadoEfeitos restrito ao retângulo, sem calcular os restantes.
+ * @param g Ponteiro para o grafo.
+ * @param linhaMin Primeira linha.
+ * @param colunaMin Primeira coluna.
+ * @param linhaMax Última linha.
+ * @param colunaMax Última coluna.
+ * @param resultado Resultado a preencher (libertar com libertarEfeitos).
+ * @return true se encontrou efeitos; false sem efeitos (resultado->numEfeitos == 0) ou por falta de memória
+ *         (resultado->numEfeitos == -1).
+ */
+bool calcularEfeitosRegiao(Grafo* g, int linhaMin, int colunaMin, int linhaMax, int colunaMax, ResultadoEfeitos* resultado);
+
+/**
+ * @brief Calcula os efeitos no modo harmónico: todas as células do mapa sobre a reta de cada par de antenas da mesma frequência.
+ * @details As posições das próprias antenas também contam; o grafo tem de ter as dimensões definidas.
+ * @param g Ponteiro para o grafo.
+ * @param resultado Resultado a preencher (libertar com libertarEfeitos).
+ * @return true se encontrou efeitos; false sem efeitos (resultado->numEfeitos == 0) ou por falta de memória
+ *         (resultado->numEfeitos == -1).
+ */
+bool calcularEfeitosHarmonicos(Grafo* g, ResultadoEfeitos* resultado);
+
+/**
+ * @brief Liberta de uma vez todos os efeitos de um resultado.
+ * @param resultado Resultado a libertar.
+ * @return true após libertar.
+ */
+bool libertarEfeitos(ResultadoEfeitos* resultado);
+
+/**
+ * @brief Calcula o conjunto de posições afetadas por efeitos nefastos (sem construir a lista).
+ * @param g Ponteiro para o grafo.
+ * @param conjunto Conjunto a preencher; consultar com pertenceConjuntoPosicoes e libertar com libertarConjuntoPosicoes.
+ * @return true se calculou, false em caso de erro.
+ */
+bool calcularConjuntoEfeitos(Grafo* g, ConjuntoPosicoes* conjunto);
+
+/**
+ * @brief Inicializa um mapa de efeitos incremental vazio (e desativado).
+ * @param ef Ponteiro para o mapa de efeitos.
+ * @return true se inicializou, false caso contrário.
+ */
+bool iniciarEfeitosIncrementais(EfeitosIncrementais* ef);
+
+/**
+ * @brief Esvazia um mapa de efeitos incremental, sem alterar se está ativo.
+ * @param ef Ponteiro para o mapa de efeitos.
+ * @return true após libertar.
+ */
+bool libertarEfeitosIncrementais(EfeitosIncrementais* ef);
+
+/**
+ * @brief Ativa ou desativa a manutenção incremental dos efeitos nefastos.
+ * @details Com o modo ativo, inserir/remover uma antena custa O(k) (k antenas da mesma frequência) e os
+ *          cálculos de efeitos leem o mapa mantido em vez de percorrer todos os pares.
+ * @param g Ponteiro para o grafo.
+ * @param incremental true para ativar.
+ * @return true se alterou o modo, false em caso de erro.
+ */
+bool definirEfeitosIncrementais(Grafo* g, bool incremental);
+
+/**
+ * @brief Acrescenta ou retira do mapa incremental os efeitos dos pares de uma antena.
+ * @param g Ponteiro para o grafo.
+ * @param ant Ponteiro para a antena (já no balde da sua frequência).
+ * @param sinal +1 ao inserir a antena, -1 ao removê-la.
+ * @return true se atualizou, false se o modo não está ativo ou em caso de erro.
+ */
+bool atualizarEfeitosAntena(Grafo* g, VAntena* ant, int sinal);
+
+/**
+ * @brief Devolve quantas contribuições (par de antenas, lado) produzem efeito numa posição.
+ * @param g Ponteiro para o grafo.
+ * @param linha Linha.
+ * @param coluna Coluna.
+ * @return Número de contribuições (0 se não há efeito), ou -1 se o modo incremental não está ativo.
+ */
+int contribuicoesEfeito(Grafo* g, int linha, int coluna);
+
+/**
+ * @brief Devolve o número de posições com efeito nefasto no mapa incremental.
+ * @param g Ponteiro para o grafo.
+ * @return Número de posições, ou -1 se o modo incremental não está ativo.
+ */
+int numeroEfeitosIncrementais(Grafo* g);
+
+/**
+ * @brief Calcula as posições dos efeitos nefastos de um par de antenas da mesma frequência.
+ * @details Os efeitos ficam nos prolongamentos do segmento entre as antenas, à mesma distância: a1 - (a2 - a1)
+ *          e a2 + (a2 - a1). Só contam posições com linha e coluna não negativas.
+ * @param linha1 Linha da primeira antena.
+ * @param coluna1 Coluna da primeira antena.
+ * @param linha2 Linha da segunda antena.
+ * @param coluna2 Coluna da segunda antena.
+ * @param posicoes Destino das posições válidas ({linha, coluna}), a partir do início.
+ * @return Número de posições válidas (0 a 2).
+ */
+int posicoesEfeitoPar(int linha1, int coluna1, int linha2, int coluna2, int posicoes[2][2]);
+
 /**
  * @brief Verifica se já existe um efeito nefasto numa posição.
  * @param lista Lista de efeitos nefastos.
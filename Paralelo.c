@@ -0,0 +1,301 @@
+#ifndef PARALELO_C
+#define PARALELO_C
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <pthread.h>
+#include "Nefasto.h"
+#include "Indice.h"
+#include "Memoria.h"
+#include "Paralelo.h"
+#include "Metricas.h"
+/**
+ * @file Paralelo.c
+ * @brief Implementação do cálculo paralelo de efeitos nefastos.
+ * @author João Novais
+ * @date 2025-05-18
+ *
+ */
+
+#pragma region Paralelo
+
+// Abaixo deste número de pares o cálculo é feito sem criar threads
+#define PARALELO_PARES_MINIMOS (1LL << 16)
+// Número de tarefas por thread (tarefas mais pequenas equilibram melhor a carga)
+#define PARALELO_TAREFAS_POR_THREAD 8
+// Maior mapa de bits local a cada thread; acima disso usa a tabela de dispersão
+#define PARALELO_BITS_LOCAIS (1LL << 23)
+
+/**
+ * @brief Fatia do ciclo exterior de um balde: antenas [inicio, fim) emparelhadas com as seguintes.
+ */
+typedef struct TarefaEfeitos {
+    int frequencia;
+    int inicio, fim;
+} TarefaEfeitos;
+
+/**
+ * @brief Efeito encontrado por uma thread, antes da junção.
+ */
+typedef struct RegistoEfeito {
+    int linha, coluna;
+    unsigned char frequencia;
+} RegistoEfeito;
+
+/**
+ * @brief Estado de cada thread de trabalho.
+ */
+typedef struct TrabalhadorEfeitos {
+    Grafo* g;
+    TarefaEfeitos* tarefas;
+    int numTarefas;
+    int* proximaTarefa;
+    pthread_mutex_t* trinco;
+    RegistoEfeito* registos;
+    int numRegistos, capacidade;
+    bool erro;
+} TrabalhadorEfeitos;
+
+/**
+ * @brief Acrescenta um efeito aos registos da thread.
+ * @param t Estado da thread.
+ * @param linha Linha.
+ * @param coluna Coluna.
+ * @param freq Frequência.
+ * @return true se acrescentou, false em caso de erro de memória.
+ */
+static bool registarEfeito(TrabalhadorEfeitos* t, int linha, int coluna, unsigned char freq) {
+    if (t->numRegistos == t->capacidade) {
+        int capacidade = t->capacidade ? t->capacidade * 2 : 1024;
+        RegistoEfeito* novo = realloc(t->registos, (size_t)capacidade * sizeof(RegistoEfeito));
+        if (!novo) return false;
+        t->registos = novo;
+        t->capacidade = capacidade;
+    }
+    t->registos[t->numRegistos].linha = linha;
+    t->registos[t->numRegistos].coluna = coluna;
+    t->registos[t->numRegistos].frequencia = freq;
+    t->numRegistos++;
+    return true;
+}
+
+/**
+ * @brief Corpo de cada thread: vai buscando tarefas e acumula os efeitos num conjunto local.
+ * @param arg Ponteiro para TrabalhadorEfeitos.
+ * @return NULL.
+ */
+static void* trabalharEfeitos(void* arg) {
+    TrabalhadorEfeitos* t = (TrabalhadorEfeitos*)arg;
+    Grafo* g = t->g;
+
+    long long area = (long long)g->linhas * g->colunas;
+    ConjuntoPosicoes vistos;
+    bool comBits = area <= PARALELO_BITS_LOCAIS;
+    if (!iniciarConjuntoPosicoes(&vistos, comBits ? g->linhas : 0, comBits ? g->colunas : 0)) {
+        t->erro = true;
+        return NULL;
+    }
+
+    while (!t->erro) {
+        pthread_mutex_lock(t->trinco);
+        int k = (*t->proximaTarefa)++;
+        pthread_mutex_unlock(t->trinco);
+        if (k >= t->numTarefas) break;
+
+        TarefaEfeitos* tarefa = &t->tarefas[k];
+        BaldeFrequencia* b = &g->baldes[tarefa->frequencia];
+        for (int i = tarefa->inicio; i < tarefa->fim && !t->erro; i++) {
+            VAntena* atual = b->antenas[i];
+            for (int j = i + 1; j < b->numAntenas; j++) {
+                VAntena* atual2 = b->antenas[j];
+                int efeitos[2][2];
+                int n = posicoesEfeitoPar(atual->linha, atual->coluna, atual2->linha, atual2->coluna, efeitos);
+                for (int k = 0; k < n; k++) {
+                    if (adicionarConjuntoPosicoes(&vistos, efeitos[k][0], efeitos[k][1])) {
+                        if (!registarEfeito(t, efeitos[k][0], efeitos[k][1], (unsigned char)tarefa->frequencia))
+                            t->erro = true;
+                    } else if (!pertenceConjuntoPosicoes(&vistos, efeitos[k][0], efeitos[k][1])) {
+                        t->erro = true; // Não ficou no conjunto: falta de memória na tabela
+                    }
+                }
+            }
+        }
+    }
+    libertarConjuntoPosicoes(&vistos);
+    return NULL;
+}
+
+/**
+ * @brief Compara dois registos por (linha, coluna, frequência), para qsort.
+ * @param a Ponteiro para RegistoEfeito.
+ * @param b Ponteiro para RegistoEfeito.
+ * @return Negativo, zero ou positivo.
+ */
+static int compararRegistos(const void* a, const void* b) {
+    const RegistoEfeito* x = (const RegistoEfeito*)a;
+    const RegistoEfeito* y = (const RegistoEfeito*)b;
+    if (x->linha != y->linha) return x->linha < y->linha ? -1 : 1;
+    if (x->coluna != y->coluna) return x->coluna < y->coluna ? -1 : 1;
+    return (int)x->frequencia - (int)y->frequencia;
+}
+
+/**
+ * @brief Reparte os pares de cada balde em tarefas com um número de pares semelhante.
+ * @param g Ponteiro para o grafo.
+ * @param paresPorTarefa Número de pares pretendido em cada tarefa.
+ * @param numTarefas Ponteiro onde fica o número de tarefas criadas.
+ * @return Vetor de tarefas (libertar com free), ou NULL em caso de erro.
+ */
+static TarefaEfeitos* repartirTarefas(Grafo* g, long long paresPorTarefa, int* numTarefas) {
+    int capacidade = 64, n = 0;
+    TarefaEfeitos* tarefas = malloc((size_t)capacidade * sizeof(TarefaEfeitos));
+    if (!tarefas) return NULL;
+
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+        int k = g->baldes[f].numAntenas;
+        int inicio = 0;
+        while (inicio < k - 1) {
+            // A antena i contribui com k-1-i pares: junta antenas até chegar aos pares pretendidos
+            long long pares = 0;
+            int fim = inicio;
+            while (fim < k - 1 && pares < paresPorTarefa) pares += k - 1 - fim++;
+            if (n == capacidade) {
+                capacidade *= 2;
+                TarefaEfeitos* novo = realloc(tarefas, (size_t)capacidade * sizeof(TarefaEfeitos));
+                if (!novo) {
+                    free(tarefas);
+                    return NULL;
+                }
+                tarefas = novo;
+            }
+            tarefas[n].frequencia = f;
+            tarefas[n].inicio = inicio;
+            tarefas[n].fim = fim;
+            n++;
+            inicio = fim;
+        }
+    }
+    *numTarefas = n;
+    return tarefas;
+}
+
+/**
+ * @brief Corpo de calcularResultadoEfeitosParalelo, sem a medição de tempo (ver calcularResultadoEfeitosParalelo).
+ */
+static bool calcularResultadoEfeitosParaleloInterno(Grafo* g, ResultadoEfeitos* resultado, int numThreads) {
+    if (!resultado) return false;
+    resultado->lista = NULL;
+    resultado->numEfeitos = 0;
+    iniciarArena(&resultado->arena, sizeof(EfeitoNefasto));
+    if (!g || g->numAntenas < 2) return false;
+
+    long long totalPares = 0;
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+        long long k = g->baldes[f].numAntenas;
+        totalPares += k * (k - 1) / 2;
+    }
+    METRICA_CONTAR(g, paresExaminados, totalPares);
+    if (numThreads < 1 || totalPares < PARALELO_PARES_MINIMOS) numThreads = 1;
+
+    long long paresPorTarefa = totalPares / ((long long)numThreads * PARALELO_TAREFAS_POR_THREAD) + 1;
+    int numTarefas = 0;
+    TarefaEfeitos* tarefas = repartirTarefas(g, paresPorTarefa, &numTarefas);
+    TrabalhadorEfeitos* trabalhadores = calloc((size_t)numThreads, sizeof(TrabalhadorEfeitos));
+    pthread_t* threads = malloc((size_t)numThreads * sizeof(pthread_t));
+    if (!tarefas || !trabalhadores || !threads) {
+        free(tarefas);
+        free(trabalhadores);
+        free(threads);
+        resultado->numEfeitos = -1;
+        return false;
+    }
+
+    pthread_mutex_t trinco;
+    pthread_mutex_init(&trinco, NULL);
+    int proximaTarefa = 0;
+    for (int t = 0; t < numThreads; t++) {
+        trabalhadores[t].g = g;
+        trabalhadores[t].tarefas = tarefas;
+        trabalhadores[t].numTarefas = numTarefas;
+        trabalhadores[t].proximaTarefa = &proximaTarefa;
+        trabalhadores[t].trinco = &trinco;
+    }
+    // Com uma só thread, o trabalho é feito aqui mesmo
+    int criadas = 0;
+    if (numThreads > 1) {
+        while (criadas < numThreads &&
+               pthread_create(&threads[criadas], NULL, trabalharEfeitos, &trabalhadores[criadas]) == 0)
+            criadas++;
+    }
+    if (criadas == 0) trabalharEfeitos(&trabalhadores[0]);
+    for (int t = 0; t < criadas; t++) pthread_join(threads[t], NULL);
+    pthread_mutex_destroy(&trinco);
+
+    // Junta os registos de todas as threads
+    bool erro = false;
+    long long total = 0;
+    for (int t = 0; t < numThreads; t++) {
+        erro = erro || trabalhadores[t].erro;
+        total += trabalhadores[t].numRegistos;
+    }
+    RegistoEfeito* todos = erro ? NULL : malloc((size_t)(total ? total : 1) * sizeof(RegistoEfeito));
+    if (!todos) erro = true;
+    else {
+        long long k = 0;
+        for (int t = 0; t < numThreads; t++) {
+            for (int i = 0; i < trabalhadores[t].numRegistos; i++) todos[k++] = trabalhadores[t].registos[i];
+        }
+        qsort(todos, (size_t)total, sizeof(RegistoEfeito), compararRegistos);
+
+        // Percorre de trás para a frente para a lista ficar por ordem crescente
+        for (long long i = total - 1; i >= 0; i--) {
+            if (i > 0 && todos[i - 1].linha == todos[i].linha && todos[i - 1].coluna == todos[i].coluna)
+                continue; // Fica só o de frequência mais baixa
+            EfeitoNefasto* lista = inserirEfeitoArena(&resultado->arena, resultado->lista,
+                                                      todos[i].linha, todos[i].coluna, (char)todos[i].frequencia);
+            if (lista == resultado->lista) {
+                erro = true;
+                break;
+            }
+            resultado->lista = lista;
+        }
+        resultado->numEfeitos = resultado->arena.numObjetos;
+        METRICA_CONTAR(g, efeitosEncontrados, resultado->numEfeitos);
+    }
+
+    for (int t = 0; t < numThreads; t++) free(trabalhadores[t].registos);
+    free(todos);
+    free(tarefas);
+    free(trabalhadores);
+    free(threads);
+    if (erro) {
+        // Sem memória: o resultado parcial não serve e fica marcado para não se confundir com "sem efeitos"
+        libertarEfeitos(resultado);
+        resultado->numEfeitos = -1;
+        return false;
+    }
+    return resultado->lista != NULL;
+}
+
+/**
+ * @brief Calcula todos os efeitos nefastos do grafo usando várias threads.
+ * @details Cada thread elimina repetidos no seu próprio conjunto; no fim os registos são ordenados por
+ *          (linha, coluna, frequência) e fica o primeiro de cada posição, o que dá sempre o mesmo resultado
+ *          (frequência mais baixa, como na versão sequencial, que percorre os baldes por ordem).
+ *          Se faltar memória (numa thread, na repartição ou na junção) o resultado fica vazio com numEfeitos a -1,
+ *          para se distinguir de um grafo sem efeitos (numEfeitos a 0).
+ * @param g Ponteiro para o grafo.
+ * @param resultado Resultado a preencher (libertar com libertarEfeitos).
+ * @param numThreads Número de threads de trabalho.
+ * @return true se encontrou efeitos, false caso contrário (ver resultado->numEfeitos).
+ */
+bool calcularResultadoEfeitosParalelo(Grafo* g, ResultadoEfeitos* resultado, int numThreads) {
+    METRICA_INICIO(inicio);
+    bool r = calcularResultadoEfeitosParaleloInterno(g, resultado, numThreads);
+    METRICA_FIM(g, METRICA_EFEITOS_PARALELO, inicio);
+    return r;
+}
+
+#pragma endregion
+#endif
@@ -0,0 +1,27 @@
+#ifndef PARALELO_H
+#define PARALELO_H
+
+#include <stdbool.h>
+#include "Dados.h"
+
+/**
+ * @file Paralelo.h
+ * @brief Cálculo de efeitos nefastos repartido por várias threads.
+ * @author João Novais
+ * @date 2025-05-18
+ */
+
+/**
+ * @brief Calcula todos os efeitos nefastos do grafo usando várias threads.
+ * @details O resultado tem o mesmo conjunto de efeitos que calcularResultadoEfeitos e vem sempre pela mesma
+ *          ordem (linha, depois coluna), qualquer que seja o número de threads. Em mapas pequenos, ou com
+ *          numThreads <= 1, o cálculo é feito na própria thread que chama.
+ * @param g Ponteiro para o grafo.
+ * @param resultado Resultado a preencher (libertar com libertarEfeitos).
+ * @param numThreads Número de threads de trabalho.
+ * @return true se encontrou efeitos; false sem efeitos (resultado->numEfeitos == 0) ou por falta de memória
+ *         (resultado->numEfeitos == -1).
+ */
+bool calcularResultadoEfeitosParalelo(Grafo* g, ResultadoEfeitos* resultado, int numThreads);
+
+#endif
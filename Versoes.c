@@ -0,0 +1,146 @@
+#ifndef VERSOES_C
+#define VERSOES_C
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdatomic.h>
+#include <sched.h>
+#include "Compacto.h"
+#include "Versoes.h"
+#include "Metricas.h"
+/**
+ * @file Versoes.c
+ * @brief Implementação da publicação de versões do grafo (cópia completa em CSR e contagem de referências).
+ * @author João Novais
+ * @date 2025-05-18
+ *
+ */
+
+#pragma region Versoes
+
+/**
+ * @brief Cria um publicador sem nenhuma versão publicada.
+ * @return Ponteiro para o publicador, ou NULL em caso de erro.
+ */
+PublicadorGrafo* criarPublicador(void) {
+    PublicadorGrafo* p = (PublicadorGrafo*)malloc(sizeof(PublicadorGrafo));
+    if (!p) return NULL;
+    atomic_init(&p->atual, NULL);
+    atomic_init(&p->epoca, 0);
+    atomic_init(&p->aAdquirir[0], 0);
+    atomic_init(&p->aAdquirir[1], 0);
+    p->proximoNumero = 1;
+    return p;
+}
+
+/**
+ * @brief Liberta uma versão adquirida com adquirirVersao.
+ * @details A última referência a sair (leitor ou publicador) liberta o grafo compacto.
+ * @param v Ponteiro para a versão.
+ * @return true após libertar, false se a versão for inválida.
+ */
+bool libertarVersao(VersaoGrafo* v) {
+    if (!v) return false;
+    if (atomic_fetch_sub(&v->referencias, 1) == 1) {
+        libertarGrafoCompacto(v->compacto);
+        free(v);
+    }
+    return true;
+}
+
+/**
+ * @brief Troca a versão atual e larga a referência do publicador à anterior.
+ * @details Antes de largar a versão antiga espera que terminem os leitores que estavam a meio de
+ *          adquirirVersao (podem tê-la lido mas ainda não ter a sua referência). Depois de avançar a época,
+ *          os leitores novos contam na outra metade de aAdquirir e os que ainda leram a época antiga desistem
+ *          dela, por isso a espera acaba quando saírem os leitores que já lá estavam, por muitos que continuem
+ *          a chegar. Os leitores nunca esperam pelo escritor.
+ * @param p Ponteiro para o publicador.
+ * @param nova Nova versão (ou NULL).
+ */
+static void trocarVersao(PublicadorGrafo* p, VersaoGrafo* nova) {
+    VersaoGrafo* antiga = atomic_exchange(&p->atual, nova);
+    unsigned int epoca = atomic_fetch_add(&p->epoca, 1);
+    while (atomic_load(&p->aAdquirir[epoca % 2]) != 0) sched_yield();
+    if (antiga) libertarVersao(antiga);
+}
+
+/**
+ * @brief Destrói o publicador; as versões ainda adquiridas por leitores continuam válidas até serem libertadas.
+ * @details Não pode haver leitores a chamar adquirirVersao sobre este publicador durante ou depois da destruição.
+ * @param p Ponteiro para o publicador.
+ * @return true após destruir, false se o publicador for inválido.
+ */
+bool destruirPublicador(PublicadorGrafo* p) {
+    if (!p) return false;
+    trocarVersao(p, NULL);
+    free(p);
+    return true;
+}
+
+/**
+ * @brief Corpo de publicarGrafo, sem a medição de tempo (ver publicarGrafo).
+ */
+static bool publicarGrafoInterno(PublicadorGrafo* p, Grafo* g) {
+    if (!p || !g) return false;
+    VersaoGrafo* nova = (VersaoGrafo*)malloc(sizeof(VersaoGrafo));
+    if (!nova) return false;
+    nova->compacto = congelarGrafo(g);
+    if (!nova->compacto) {
+        free(nova);
+        return false;
+    }
+    nova->numero = p->proximoNumero++;
+    atomic_init(&nova->referencias, 1); // referência do publicador
+    trocarVersao(p, nova);
+    return true;
+}
+
+/**
+ * @brief Publica o estado atual do grafo como nova versão (só pode ser chamada por um escritor de cada vez).
+ * @details O grafo é copiado inteiro para um GrafoCompacto (congelarGrafo), que nunca mais é alterado: os leitores
+ *          da versão anterior continuam a vê-la intacta enquanto o escritor altera o Grafo e publica outra.
+ *          Cada publicação custa O(N + E) em tempo e memória (N antenas, E ligações explícitas; as implícitas
+ *          da mesma frequência não são expandidas), mesmo que o grafo quase não tenha mudado: convém publicar
+ *          por lotes de alterações e não a cada uma.
+ *          As travessias sobre a versão (DFSCompacto, DFSTraversalCompacto) guardam o estado em memória própria
+ *          de cada chamada, por isso vários leitores podem percorrer a mesma versão ao mesmo tempo.
+ * @param p Ponteiro para o publicador.
+ * @param g Ponteiro para o grafo (que só o escritor altera).
+ * @return true se publicou, false em caso de erro (a versão anterior continua publicada).
+ */
+bool publicarGrafo(PublicadorGrafo* p, Grafo* g) {
+    METRICA_INICIO(inicio);
+    bool r = publicarGrafoInterno(p, g);
+    METRICA_FIM(g, METRICA_PUBLICAR, inicio);
+    return r;
+}
+
+/**
+ * @brief Adquire a versão atual, sem bloquear; a versão não muda nem é libertada até libertarVersao.
+ * @details O leitor anuncia-se em aAdquirir (na metade da época atual) antes de ler a versão atual e só sai
+ *          depois de somar a sua referência, para o escritor não libertar a versão nesse intervalo. Se a época
+ *          mudar entre a leitura e o anúncio, o escritor pode já não estar à espera dessa metade: o leitor
+ *          desfaz o anúncio e repete com a época nova (só acontece quando uma publicação avançou).
+ * @param p Ponteiro para o publicador.
+ * @return Ponteiro para a versão, ou NULL se ainda não foi publicada nenhuma.
+ */
+VersaoGrafo* adquirirVersao(PublicadorGrafo* p) {
+    if (!p) return NULL;
+    unsigned int epoca = atomic_load(&p->epoca);
+    atomic_fetch_add(&p->aAdquirir[epoca % 2], 1);
+    while (atomic_load(&p->epoca) != epoca) {
+        atomic_fetch_sub(&p->aAdquirir[epoca % 2], 1);
+        epoca = atomic_load(&p->epoca);
+        atomic_fetch_add(&p->aAdquirir[epoca % 2], 1);
+    }
+    VersaoGrafo* v = atomic_load(&p->atual);
+    if (v) atomic_fetch_add(&v->referencias, 1);
+    atomic_fetch_sub(&p->aAdquirir[epoca % 2], 1);
+    return v;
+}
+
+#pragma endregion
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef VERSOES_H
+#define VERSOES_H
+
+#include <stdbool.h>
+#include "Dados.h"
+
+/**
+ * @file Versoes.h
+ * @brief Publicação de versões imutáveis do grafo para leitores concorrentes (isolamento por instantâneo).
+ * @author João Novais
+ * @date 2025-05-18
+ */
+
+/**
+ * @brief Cria um publicador sem nenhuma versão publicada.
+ * @return Ponteiro para o publicador, ou NULL em caso de erro.
+ */
+PublicadorGrafo* criarPublicador(void);
+
+/**
+ * @brief Destrói o publicador; as versões ainda adquiridas por leitores continuam válidas até serem libertadas.
+ * @param p Ponteiro para o publicador.
+ * @return true após destruir, false se o publicador for inválido.
+ */
+bool destruirPublicador(PublicadorGrafo* p);
+
+/**
+ * @brief Publica o estado atual do grafo como nova versão (só pode ser chamada por um escritor de cada vez).
+ * @details Copia o grafo inteiro (congelarGrafo): O(N + E) em tempo e memória por publicação (E só conta as
+ *          ligações explícitas).
+ * @param p Ponteiro para o publicador.
+ * @param g Ponteiro para o grafo (que só o escritor altera).
+ * @return true se publicou, false em caso de erro (a versão anterior continua publicada).
+ */
+bool publicarGrafo(PublicadorGrafo* p, Grafo* g);
+
+/**
+ * @brief Adquire a versão atual, sem bloquear; a versão não muda nem é libertada até libertarVersao.
+ * @param p Ponteiro para o publicador.
+ * @return Ponteiro para a versão, ou NULL se ainda não foi publicada nenhuma.
+ */
+VersaoGrafo* adquirirVersao(PublicadorGrafo* p);
+
+/**
+ * @brief Liberta uma versão adquirida com adquirirVersao.
+ * @param v Ponteiro para a versão.
+ * @return true após libertar, false se a versão for inválida.
+ */
+bool libertarVersao(VersaoGrafo* v);
+
+#endif
@@ -0,0 +1,317 @@
+/**
+ * @file benchmark.c
+ * @brief Programa de medição de desempenho da biblioteca (libEDA.a) com gerador de mapas sintéticos.
+ * @details Para cada tamanho (o lado do mapa duplica desde -m até -M) gera um mapa aleatório com a densidade
+ *          e o número de frequências pedidos e mede lerMatrizAntenas, conectarAntenasMesmoTipo,
+ *          calcularEfeitosNefastos, DFSTraversal_Antena, escreverMapaComEfeitos e as idas e voltas binárias
+ *          (formato antigo e v2). Cada tempo é o melhor de -r repetições; a coluna "fator" compara com o
+ *          tamanho anterior (duplicar o lado multiplica a área por 4). Os resultados vão para stderr (e,
+ *          com -o, para um ficheiro CSV); stdout recebe as impressões da travessia e pode ser descartado.
+ *
+ *          Compilar a partir da raiz do projeto com "make benchmark" (constrói libEDA.a com todos os módulos e
+ *          liga o programa a ela; ver o Makefile para a instrumentação e para Windows/MinGW). Exemplo:
+ *              benchmark/benchmark -M 2000 -d 0.005 -f 26 -o resultados.csv > /dev/null
+ *
+ * @author João Novais
+ * @date 2025-05-18
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <time.h>
+#include <sys/resource.h>
+#endif
+#include "Dados.h"
+#include "Antena.h"
+#include "Grafo.h"
+#include "Nefasto.h"
+#include "Ficheiros.h"
+
+#pragma region Benchmark
+
+// Ficheiros temporários usados nas medições
+#define FICHEIRO_MAPA "benchmark_mapa.txt"
+#define FICHEIRO_SAIDA "benchmark_saida.txt"
+#define FICHEIRO_BINARIO "benchmark_mapa.bin"
+#define FICHEIRO_BINARIO_V2 "benchmark_mapa_v2.bin"
+#define FICHEIRO_BINARIO_COMPACTADO "benchmark_mapa_compactado.bin"
+
+// Operações medidas, pela ordem das colunas do relatório
+#define NUM_OPERACOES 9
+static const char* nomesOperacoes[NUM_OPERACOES] = {
+    "lerMatriz", "conectar", "efeitos", "DFSTraversal", "escreverMapa",
+    "binario", "binarioV2", "binarioV2+arestas", "binarioCompactado"
+};
+
+/**
+ * @brief Parâmetros do benchmark (linha de comandos).
+ */
+typedef struct ParametrosBenchmark {
+    int ladoMinimo;
+    int ladoMaximo;
+    double densidade;
+    int numFrequencias;
+    int repeticoes;
+    unsigned semente;
+    bool implicitas;
+    const char* ficheiroCSV;
+} ParametrosBenchmark;
+
+/**
+ * @brief Devolve o tempo atual em segundos (relógio monotónico).
+ * @return Tempo em segundos.
+ */
+static double agora(void) {
+#ifdef _WIN32
+    LARGE_INTEGER freq, t;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&t);
+    return (double)t.QuadPart / (double)freq.QuadPart;
+#else
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double)t.tv_sec + (double)t.tv_nsec * 1e-9;
+#endif
+}
+
+/**
+ * @brief Devolve o pico de memória residente do processo.
+ * @return Pico em KiB, ou 0 se não for possível obtê-lo.
+ */
+static long picoMemoriaKiB(void) {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) return 0;
+    return (long)(pmc.PeakWorkingSetSize / 1024);
+#else
+    struct rusage uso;
+    if (getrusage(RUSAGE_SELF, &uso) != 0) return 0;
+#ifdef __APPLE__
+    return uso.ru_maxrss / 1024; // macOS devolve bytes
+#else
+    return uso.ru_maxrss;
+#endif
+#endif
+}
+
+/**
+ * @brief Gera um número pseudo-aleatório (xorshift32), independente do rand() da plataforma.
+ * @param estado Ponteiro para o estado do gerador.
+ * @return Próximo valor.
+ */
+static unsigned aleatorio(unsigned* estado) {
+    unsigned x = *estado;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *estado = x;
+    return x;
+}
+
+/**
+ * @brief Escreve um mapa de texto sintético.
+ * @param filename Nome do ficheiro.
+ * @param lado Número de linhas e de colunas.
+ * @param densidade Fração de células com antena (0..1).
+ * @param numFrequencias Número de frequências distintas (usa 'A'..'Z', 'a'..'z', '0'..'9').
+ * @param semente Semente do gerador.
+ * @return Número de antenas escritas, ou -1 em caso de erro.
+ */
+static long gerarMapa(const char* filename, int lado, double densidade, int numFrequencias, unsigned semente) {
+    static const char simbolos[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789";
+    FILE* f = fopen(filename, "wb");
+    if (!f) return -1;
+    char* linha = malloc((size_t)lado + 1);
+    if (!linha) {
+        fclose(f);
+        return -1;
+    }
+    unsigned estado = semente ? semente : 1;
+    unsigned limiar = (unsigned)(densidade * 4294967295.0);
+    long numAntenas = 0;
+    linha[lado] = '\n';
+    for (int l = 0; l < lado; l++) {
+        for (int c = 0; c < lado; c++) {
+            if (aleatorio(&estado) < limiar) {
+                linha[c] = simbolos[aleatorio(&estado) % (unsigned)numFrequencias];
+                numAntenas++;
+            } else {
+                linha[c] = '.';
+            }
+        }
+        fwrite(linha, 1, (size_t)lado + 1, f);
+    }
+    free(linha);
+    fclose(f);
+    return numAntenas;
+}
+
+/**
+ * @brief Mede uma ronda de todas as operações para um mapa já gerado.
+ * @param p Parâmetros.
+ * @param tempos Vetor (NUM_OPERACOES) onde guardar os tempos, em segundos.
+ * @param numEfeitos Ponteiro onde guardar o número de efeitos encontrados.
+ * @return true se mediu, false em caso de erro.
+ */
+static bool medirRonda(const ParametrosBenchmark* p, double* tempos, long* numEfeitos) {
+    Grafo* g = criarGrafo();
+    if (!g) return false;
+    definirArestasImplicitas(g, p->implicitas);
+    int linhas = 0, colunas = 0;
+
+    double t0 = agora();
+    bool ok = lerMatrizAntenas(g, FICHEIRO_MAPA, &linhas, &colunas);
+    tempos[0] = agora() - t0;
+
+    t0 = agora();
+    ok = ok && conectarAntenasMesmoTipo(g);
+    tempos[1] = agora() - t0;
+
+    bool encontrou = false;
+    t0 = agora();
+    EfeitoNefasto* efeitos = calcularEfeitosNefastos(g, &encontrou);
+    tempos[2] = agora() - t0;
+    *numEfeitos = 0;
+    for (EfeitoNefasto* e = efeitos; e != NULL; e = e->proximo) (*numEfeitos)++;
+
+    t0 = agora();
+    DFSTraversal_Antena(g);
+    fflush(stdout);
+    tempos[3] = agora() - t0;
+
+    t0 = agora();
+    ok = ok && escreverMapaComEfeitos(FICHEIRO_SAIDA, g, efeitos, linhas, colunas);
+    tempos[4] = agora() - t0;
+    libertarListaEfeitos(efeitos);
+
+    // Idas e voltas binárias: guardar e voltar a ler para um grafo novo
+    Grafo* copia = criarGrafo();
+    if (!copia) ok = false;
+    t0 = agora();
+    ok = ok && guardarBinario(FICHEIRO_BINARIO, g) && lerBinario(FICHEIRO_BINARIO, copia);
+    tempos[5] = agora() - t0;
+    t0 = agora();
+    ok = ok && guardarBinarioV2(FICHEIRO_BINARIO_V2, g, false) && lerBinario(FICHEIRO_BINARIO_V2, copia);
+    tempos[6] = agora() - t0;
+    t0 = agora();
+    ok = ok && guardarBinarioV2(FICHEIRO_BINARIO_V2, g, true) && lerBinario(FICHEIRO_BINARIO_V2, copia);
+    tempos[7] = agora() - t0;
+    t0 = agora();
+    ok = ok && guardarBinarioCompactado(FICHEIRO_BINARIO_COMPACTADO, g) && lerBinario(FICHEIRO_BINARIO_COMPACTADO, copia);
+    tempos[8] = agora() - t0;
+    ok = ok && copia->numAntenas == g->numAntenas;
+
+    destruirGrafo(copia);
+    destruirGrafo(g);
+    return ok;
+}
+
+/**
+ * @brief Lê os parâmetros da linha de comandos.
+ * @param argc Número de argumentos.
+ * @param argv Argumentos.
+ * @param p Parâmetros a preencher (já com os valores por omissão).
+ * @return true se os parâmetros são válidos, false caso contrário.
+ */
+static bool lerParametros(int argc, char** argv, ParametrosBenchmark* p) {
+    for (int i = 1; i < argc; i++) {
+        const char* a = argv[i];
+        const char* v = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(a, "-i") == 0) { p->implicitas = true; continue; }
+        if (!v) return false;
+        if (strcmp(a, "-m") == 0) p->ladoMinimo = atoi(v);
+        else if (strcmp(a, "-M") == 0) p->ladoMaximo = atoi(v);
+        else if (strcmp(a, "-d") == 0) p->densidade = atof(v);
+        else if (strcmp(a, "-f") == 0) p->numFrequencias = atoi(v);
+        else if (strcmp(a, "-r") == 0) p->repeticoes = atoi(v);
+        else if (strcmp(a, "-s") == 0) p->semente = (unsigned)strtoul(v, NULL, 10);
+        else if (strcmp(a, "-o") == 0) p->ficheiroCSV = v;
+        else return false;
+        i++;
+    }
+    return p->ladoMinimo > 0 && p->ladoMaximo >= p->ladoMinimo && p->densidade > 0 && p->densidade <= 1 &&
+           p->numFrequencias >= 1 && p->numFrequencias <= 62 && p->repeticoes >= 1;
+}
+
+int main(int argc, char** argv) {
+    ParametrosBenchmark p = { 125, 1000, 0.005, 26, 3, 12345u, false, NULL };
+    if (!lerParametros(argc, argv, &p)) {
+        fprintf(stderr,
+                "Uso: %s [-m ladoMin] [-M ladoMax] [-d densidade] [-f frequencias] [-r repeticoes]\n"
+                "          [-s semente] [-i (ligações implícitas)] [-o resultados.csv]\n", argv[0]);
+        return 1;
+    }
+    FILE* csv = p.ficheiroCSV ? fopen(p.ficheiroCSV, "w") : NULL;
+    if (p.ficheiroCSV && !csv) {
+        fprintf(stderr, "Não foi possível abrir %s\n", p.ficheiroCSV);
+        return 1;
+    }
+    if (csv) {
+        fprintf(csv, "lado,antenas,efeitos");
+        for (int o = 0; o < NUM_OPERACOES; o++) fprintf(csv, ",%s_s", nomesOperacoes[o]);
+        fprintf(csv, ",pico_kib\n");
+    }
+
+    fprintf(stderr, "densidade=%g frequencias=%d repeticoes=%d ligacoes=%s\n",
+            p.densidade, p.numFrequencias, p.repeticoes, p.implicitas ? "implicitas" : "explicitas");
+    double anteriores[NUM_OPERACOES] = { 0 };
+    bool falhou = false;
+
+    for (int lado = p.ladoMinimo; lado <= p.ladoMaximo && !falhou; lado *= 2) {
+        long numAntenas = gerarMapa(FICHEIRO_MAPA, lado, p.densidade, p.numFrequencias, p.semente + (unsigned)lado);
+        if (numAntenas < 0) {
+            fprintf(stderr, "Erro ao gerar o mapa %dx%d\n", lado, lado);
+            falhou = true;
+            break;
+        }
+
+        double melhores[NUM_OPERACOES];
+        long numEfeitos = 0;
+        for (int o = 0; o < NUM_OPERACOES; o++) melhores[o] = -1;
+        for (int r = 0; r < p.repeticoes; r++) {
+            double tempos[NUM_OPERACOES];
+            if (!medirRonda(&p, tempos, &numEfeitos)) {
+                fprintf(stderr, "Erro ao medir o mapa %dx%d\n", lado, lado);
+                falhou = true;
+                break;
+            }
+            for (int o = 0; o < NUM_OPERACOES; o++) {
+                if (melhores[o] < 0 || tempos[o] < melhores[o]) melhores[o] = tempos[o];
+            }
+        }
+        if (falhou) break;
+
+        long pico = picoMemoriaKiB();
+        fprintf(stderr, "\nmapa %dx%d: %ld antenas, %ld efeitos, pico RSS %ld KiB\n", lado, lado, numAntenas, numEfeitos, pico);
+        fprintf(stderr, "  %-20s %12s %8s\n", "operacao", "tempo (ms)", "fator");
+        for (int o = 0; o < NUM_OPERACOES; o++) {
+            if (anteriores[o] > 0)
+                fprintf(stderr, "  %-20s %12.3f %8.2f\n", nomesOperacoes[o], melhores[o] * 1e3, melhores[o] / anteriores[o]);
+            else
+                fprintf(stderr, "  %-20s %12.3f %8s\n", nomesOperacoes[o], melhores[o] * 1e3, "-");
+            anteriores[o] = melhores[o];
+        }
+        if (csv) {
+            fprintf(csv, "%d,%ld,%ld", lado, numAntenas, numEfeitos);
+            for (int o = 0; o < NUM_OPERACOES; o++) fprintf(csv, ",%.6f", melhores[o]);
+            fprintf(csv, ",%ld\n", pico);
+            fflush(csv);
+        }
+        if (lado > p.ladoMaximo / 2) break; // evita overflow de lado *= 2
+    }
+
+    if (csv) fclose(csv);
+    remove(FICHEIRO_MAPA);
+    remove(FICHEIRO_SAIDA);
+    remove(FICHEIRO_BINARIO);
+    remove(FICHEIRO_BINARIO_V2);
+    remove(FICHEIRO_BINARIO_COMPACTADO);
+    return falhou ? 1 : 0;
+}
+
+#pragma endregion